@@ -27,10 +27,14 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <vector>
 
 #include "oct-locbuf.h"
 #include "oct-norm.h"
+#include "sparse-util.h"
 
 #include "defun.h"
 #include "error.h"
@@ -78,6 +82,168 @@ ichol_checkpivot_real (double pivot)
   return true;
 }
 
+// Same tests as ichol_checkpivot_real and ichol_checkpivot_complex, but
+// without raising an error, for use in parallel code.
+static bool
+ichol_pivot_ok (double pivot)
+{
+  return ! (pivot < 0);
+}
+
+static bool
+ichol_pivot_ok (Complex pivot)
+{
+  return ! (fabs (pivot.imag ()) > std::numeric_limits<double>::epsilon ()
+            || pivot.real () < 0);
+}
+
+// Level-scheduled variant of ichol_0 without diagonal compensation.
+// Column k is updated by the columns jrow < k that have a nonzero in row k.
+// Columns are grouped into levels that only depend on previous levels, and
+// the columns of a level are factorized in parallel.  The updates of a column
+// are applied in increasing order of jrow instead of the order of the linked
+// lists of ichol_0, so results can differ by rounding.  Return false without
+// modifying SM if the matrix is too small or the levels are too narrow for
+// threads to pay off.
+
+template <typename octave_matrix_t, typename T, T (*ichol_mult) (T, T),
+          bool (*ichol_checkpivot) (T)>
+bool
+ichol_0_levels (octave_matrix_t& sm)
+{
+  const octave_idx_type n = sm.cols ();
+  const octave_idx_type *cidx = sm.cidx ();
+  const octave_idx_type *ridx = sm.ridx ();
+  const octave_idx_type nnz = cidx[n];
+
+  int nt = sparse_level_nthreads (nnz, n, 1);
+  if (nt <= 1)
+    return false;
+
+  // Row structure of the strictly lower triangular part: the columns with
+  // a nonzero in row k and the positions of these nonzeros.
+  std::vector<octave_idx_type> rptr (n + 1, 0);
+  for (octave_idx_type c = 0; c < n; c++)
+    for (octave_idx_type j = cidx[c]; j < cidx[c+1]; j++)
+      if (ridx[j] > c)
+        rptr[ridx[j]+1]++;
+  for (octave_idx_type k = 0; k < n; k++)
+    rptr[k+1] += rptr[k];
+
+  std::vector<octave_idx_type> rcol (rptr[n]);
+  std::vector<octave_idx_type> rpos (rptr[n]);
+  std::vector<octave_idx_type> next (rptr.begin (), rptr.end () - 1);
+  for (octave_idx_type c = 0; c < n; c++)
+    for (octave_idx_type j = cidx[c]; j < cidx[c+1]; j++)
+      if (ridx[j] > c)
+        {
+          octave_idx_type q = next[ridx[j]]++;
+          rcol[q] = c;
+          rpos[q] = j;
+        }
+
+  std::vector<octave_idx_type> level (n);
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      octave_idx_type lev = 0;
+      for (octave_idx_type q = rptr[k]; q < rptr[k+1]; q++)
+        lev = std::max (lev, level[rcol[q]] + 1);
+      level[k] = lev;
+    }
+
+  std::vector<octave_idx_type> lptr, order;
+  octave_idx_type nlevels = sparse_level_order (n, level.data (), lptr,
+                                                order);
+
+  nt = sparse_level_nthreads (nnz, n, nlevels);
+  nt = sparse_level_workspace_nthreads (nt, nnz, n, sizeof (T));
+  if (nt <= 1)
+    return false;
+
+  T *data = sm.data ();
+
+  // Status of each column: 0 on success, 1 for a missing pivot, 2 for a
+  // pivot rejected by ichol_checkpivot, and -1 if a column it depends on
+  // failed.  Dependencies have lower column numbers, so the failure with the
+  // lowest column number is the one that ichol_0 reports.
+  std::vector<int> status (n, 0);
+  std::vector<octave_idx_type> iw_all (n * nt, -1);
+  std::atomic<int> next_thread (0);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel num_threads (nt)
+#endif
+  {
+    octave_idx_type *iw = iw_all.data () + n * next_thread++;
+
+    for (octave_idx_type l = 0; l < nlevels; l++)
+      {
+#if defined (HAVE_OPENMP)
+#  pragma omp for schedule (dynamic, 16)
+#endif
+        for (octave_idx_type i = lptr[l]; i < lptr[l+1]; i++)
+          {
+            octave_idx_type k = order[i];
+
+            bool dep_failed = false;
+            for (octave_idx_type q = rptr[k]; q < rptr[k+1]; q++)
+              if (status[rcol[q]] != 0)
+                {
+                  dep_failed = true;
+                  break;
+                }
+
+            if (dep_failed)
+              {
+                status[k] = -1;
+                continue;
+              }
+
+            octave_idx_type j1 = cidx[k];
+            octave_idx_type j2 = cidx[k+1];
+            for (octave_idx_type j = j1; j < j2; j++)
+              iw[ridx[j]] = j;
+
+            for (octave_idx_type q = rptr[k]; q < rptr[k+1]; q++)
+              {
+                octave_idx_type jjrow = rpos[q];
+                octave_idx_type jend = cidx[rcol[q]+1];
+                for (octave_idx_type jj = jjrow; jj < jend; jj++)
+                  {
+                    octave_idx_type jw = iw[ridx[jj]];
+                    if (jw != -1)
+                      data[jw] -= ichol_mult (data[jj], data[jjrow]);
+                  }
+              }
+
+            if (j1 == j2 || ridx[j1] != k)
+              status[k] = 1;
+            else if (! ichol_pivot_ok (data[j1]))
+              status[k] = 2;
+            else
+              {
+                data[j1] = std::sqrt (data[j1]);
+                for (octave_idx_type j = j1 + 1; j < j2; j++)
+                  data[j] /= data[j1];
+              }
+
+            for (octave_idx_type j = j1; j < j2; j++)
+              iw[ridx[j]] = -1;
+          }
+      }
+  }
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      if (status[k] == 1)
+        error ("ichol: encountered a pivot equal to 0");
+      else if (status[k] == 2)
+        ichol_checkpivot (data[cidx[k]]);
+    }
+
+  return true;
+}
+
 template <typename octave_matrix_t, typename T, T (*ichol_mult) (T, T),
           bool (*ichol_checkpivot) (T)>
 void
@@ -94,6 +260,10 @@ ichol_0 (octave_matrix_t& sm, const std::string michol = "off")
   else
     opt = OFF;
 
+  if (opt == OFF
+      && ichol_0_levels<octave_matrix_t, T, ichol_mult, ichol_checkpivot> (sm))
+    return;
+
   // Input matrix pointers
   octave_idx_type *cidx = sm.cidx ();
   octave_idx_type *ridx = sm.ridx ();
@@ -27,8 +27,13 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #include "oct-locbuf.h"
 #include "oct-norm.h"
+#include "sparse-util.h"
 
 #include "defun.h"
 #include "error.h"
@@ -43,13 +48,15 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 // advantage of CCS format of the input matrix.  If milu = 'row' the input
 // matrix has to be transposed to obtain the equivalent CRS structure so we can
 // work efficiently with rows.  In this case IKJ version is used.
+//
+// Column k only modifies its own entries and reads the columns jrow < k of
+// its upper part, which are complete.  For large matrices, the columns are
+// grouped into levels of mutually independent columns that are eliminated
+// in parallel.
 template <typename octave_matrix_t, typename T>
 void ilu_0 (octave_matrix_t& sm, const std::string milu = "off")
 {
   const octave_idx_type n = sm.cols ();
-  octave_idx_type j1, j2, jrow, jw, i, j, k, jj;
-  T r;
-  T tl = 0;
 
   enum {OFF, ROW, COL};
   char opt;
@@ -69,70 +76,162 @@ void ilu_0 (octave_matrix_t& sm, const std::string milu = "off")
   T *data = sm.data ();
 
   // Working arrays
-  OCTAVE_LOCAL_BUFFER (octave_idx_type, iw, n);
   OCTAVE_LOCAL_BUFFER (octave_idx_type, uptr, n);
 
-  // Initialize working arrays
-  for (i = 0; i < n; i++)
-    iw[i] = -1;
+  // Eliminate column k.  The working array iw must be -1 everywhere on
+  // entry and is restored on exit.  Return 0 on success, 1 if A has a zero
+  // on the diagonal, and 2 if the pivot is zero.
+  auto eliminate = [=] (octave_idx_type k, octave_idx_type *iw) -> int
+  {
+    octave_idx_type j1 = cidx[k];
+    octave_idx_type j2 = cidx[k+1];
+
+    if (j1 == j2)
+      {
+        uptr[k] = j1;
+        return 1;
+      }
+
+    for (octave_idx_type j = j1; j < j2; j++)
+      iw[ridx[j]] = j;
+
+    T r = 0;
+    T tl = 0;
+    octave_idx_type j = j1;
+    octave_idx_type jrow = ridx[j1];
+    while ((jrow < k) && (j < j2))
+      {
+        if (opt == ROW)
+          {
+            tl = data[j] / data[uptr[jrow]];
+            data[j] = tl;
+          }
+        for (octave_idx_type jj = uptr[jrow] + 1; jj < cidx[jrow+1]; jj++)
+          {
+            octave_idx_type jw = iw[ridx[jj]];
+            if (jw != -1)
+              if (opt == ROW)
+                data[jw] -= tl * data[jj];
+              else
+                data[jw] -= data[j] * data[jj];
 
-  // Loop over all columns
-  for (k = 0; k < n; k++)
+            else
+              // That is for the milu='row'
+              if (opt == ROW)
+                r += tl * data[jj];
+              else if (opt == COL)
+                r += data[j] * data[jj];
+          }
+        j++;
+        if (j < j2)
+          jrow = ridx[j];
+      }
+    uptr[k] = j;
+
+    int status = 0;
+    if (j == j2 || k != jrow)
+      status = 1;
+    else
+      {
+        if (opt != OFF)
+          data[uptr[k]] -= r;
+
+        if (opt != ROW)
+          for (octave_idx_type jj = uptr[k] + 1; jj < cidx[k+1]; jj++)
+            data[jj] /= data[uptr[k]];
+
+        if (data[j] == T(0))
+          status = 2;
+      }
+
+    for (octave_idx_type i = j1; i < j2; i++)
+      iw[ridx[i]] = -1;
+
+    return status;
+  };
+
+  // Level of each column in the dependency graph of the elimination.
+  std::vector<octave_idx_type> level;
+  std::vector<octave_idx_type> lptr, order;
+  octave_idx_type nlevels = 0;
+  int nt = sparse_level_nthreads (cidx[n], n, 1);
+
+  if (nt > 1)
     {
-      j1 = cidx[k];
-      j2 = cidx[k+1];
+      level.resize (n);
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          octave_idx_type lev = 0;
+          for (octave_idx_type j = cidx[k]; j < cidx[k+1] && ridx[j] < k; j++)
+            lev = std::max (lev, level[ridx[j]] + 1);
+          level[k] = lev;
+        }
 
-      if (j1 == j2)
-        error ("ilu: A has a zero on the diagonal");
+      nlevels = sparse_level_order (n, level.data (), lptr, order);
+      nt = sparse_level_nthreads (cidx[n], n, nlevels);
+      nt = sparse_level_workspace_nthreads (nt, cidx[n], n, sizeof (T));
+    }
 
-      for (j = j1; j < j2; j++)
-        iw[ridx[j]] = j;
+  if (nt > 1)
+    {
+      // Status of each column, or -1 if a column it depends on failed.
+      // Dependencies have lower column numbers, so the failure with the
+      // lowest column number is the one the serial elimination reports.
+      std::vector<int> status (n, 0);
+      std::vector<octave_idx_type> iw_all (n * nt, -1);
+      std::atomic<int> next_thread (0);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel num_threads (nt)
+#endif
+      {
+        octave_idx_type *iw = iw_all.data () + n * next_thread++;
 
-      r = 0;
-      j = j1;
-      jrow = ridx[j1];
-      while ((jrow < k) && (j < j2))
-        {
-          if (opt == ROW)
-            {
-              tl = data[j] / data[uptr[jrow]];
-              data[j] = tl;
-            }
-          for (jj = uptr[jrow] + 1; jj < cidx[jrow+1]; jj++)
-            {
-              jw = iw[ridx[jj]];
-              if (jw != -1)
-                if (opt == ROW)
-                  data[jw] -= tl * data[jj];
-                else
-                  data[jw] -= data[j] * data[jj];
+        for (octave_idx_type l = 0; l < nlevels; l++)
+          {
+#if defined (HAVE_OPENMP)
+#  pragma omp for schedule (dynamic, 16)
+#endif
+            for (octave_idx_type i = lptr[l]; i < lptr[l+1]; i++)
+              {
+                octave_idx_type k = order[i];
 
-              else
-                // That is for the milu='row'
-                if (opt == ROW)
-                  r += tl * data[jj];
-                else if (opt == COL)
-                  r += data[j] * data[jj];
-            }
-          j++;
-          jrow = ridx[j];
-        }
-      uptr[k] = j;
-      if (opt != OFF)
-        data[uptr[k]] -= r;
+                bool dep_failed = false;
+                for (octave_idx_type j = cidx[k];
+                     j < cidx[k+1] && ridx[j] < k; j++)
+                  if (status[ridx[j]] != 0)
+                    {
+                      dep_failed = true;
+                      break;
+                    }
 
-      if (opt != ROW)
-        for (jj = uptr[k] + 1; jj < cidx[k+1]; jj++)
-          data[jj] /= data[uptr[k]];
+                status[k] = (dep_failed ? -1 : eliminate (k, iw));
+              }
+          }
+      }
 
-      if (k != jrow)
-        error ("ilu: A has a zero on the diagonal");
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          if (status[k] == 1)
+            error ("ilu: A has a zero on the diagonal");
+          else if (status[k] == 2)
+            error ("ilu: encountered a pivot equal to 0");
+        }
+    }
+  else
+    {
+      OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, iw, n, -1);
 
-      if (data[j] == T(0))
-        error ("ilu: encountered a pivot equal to 0");
+      // Loop over all columns
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          int status = eliminate (k, iw);
 
-      for (i = j1; i < j2; i++)
-        iw[ridx[i]] = -1;
+          if (status == 1)
+            error ("ilu: A has a zero on the diagonal");
+          else if (status == 2)
+            error ("ilu: encountered a pivot equal to 0");
+        }
     }
 
   if (opt == ROW)
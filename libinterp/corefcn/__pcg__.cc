@@ -0,0 +1,536 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "MatrixType.h"
+#include "Sparse-op-defs.h"
+#include "dColVector.h"
+#include "dDiagMatrix.h"
+#include "dMatrix.h"
+#include "dSparse.h"
+#include "oct-norm.h"
+#include "quit.h"
+#include "sparse-util.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Sparse matrix A of the iteration.  If threads pay off for the product
+// with A, the compressed row form of A, i.e., A.', is made once, so that
+// every product can be split into ranges of rows.
+
+class pcg_sparse
+{
+public:
+
+  pcg_sparse (const SparseMatrix& a)
+    : m_a (a), m_use_rows (sparse_mul_nthreads (a.nnz ()) > 1), m_rows ()
+  {
+    if (m_use_rows)
+      m_rows = a.transpose ();
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (pcg_sparse)
+
+  ~pcg_sparse () = default;
+
+  // W = A * P, reusing the storage of W.
+
+  void apply (const ColumnVector& p, ColumnVector& w) const
+  {
+    octave_idx_type n = m_a.rows ();
+
+    double *wv = w.fortran_vec ();
+    std::fill_n (wv, n, 0.0);
+
+    if (m_use_rows)
+      sparse_full_mul_rows (n, m_a.cols (), m_rows.cidx (), m_rows.ridx (),
+                            m_rows.data (), p.data (), 1, wv);
+    else
+      sparse_full_mul (n, m_a.cols (), m_a.cidx (), m_a.ridx (),
+                       m_a.data (), p.data (), 1, wv);
+  }
+
+private:
+
+  SparseMatrix m_a;
+
+  bool m_use_rows;
+
+  // A in compressed row form, if it is used.
+  SparseMatrix m_rows;
+};
+
+static void
+pcg_apply (const pcg_sparse& a, const ColumnVector& p, ColumnVector& w)
+{
+  a.apply (p, w);
+}
+
+static void
+pcg_apply (const Matrix& a, const ColumnVector& p, ColumnVector& w)
+{
+  w = a * p;
+}
+
+static void
+pcg_apply (const DiagMatrix& a, const ColumnVector& p, ColumnVector& w)
+{
+  octave_idx_type n = a.rows ();
+
+  const double *dv = a.data ();
+  const double *pv = p.data ();
+  double *wv = w.fortran_vec ();
+
+  for (octave_idx_type i = 0; i < n; i++)
+    wv[i] = dv[i] * pv[i];
+}
+
+// Level-scheduled solve with a sparse triangular matrix.  The off-diagonal
+// entries are stored by rows, and the rows are grouped into levels that
+// only depend on rows of previous levels.  The rows of a level are solved
+// in parallel.
+
+class pcg_tri_levels
+{
+public:
+
+  pcg_tri_levels ()
+    : m_nt (1), m_nlevels (0), m_lptr (), m_order (), m_rptr (), m_cols (),
+      m_vals (), m_diag ()
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (pcg_tri_levels)
+
+  ~pcg_tri_levels () = default;
+
+  // Compute the schedule for the lower or upper triangular matrix M.
+  // Return false if M has a zero on the diagonal or if threads don't pay
+  // off for M.
+
+  bool init (const SparseMatrix& m, bool lower)
+  {
+    octave_idx_type n = m.rows ();
+    octave_idx_type nnz = m.nnz ();
+    const octave_idx_type *cidx = m.cidx ();
+    const octave_idx_type *ridx = m.ridx ();
+    const double *data = m.data ();
+
+    m_nt = sparse_level_nthreads (nnz, n, 1);
+    if (m_nt <= 1)
+      return false;
+
+    m_diag.assign (n, 0.0);
+    m_rptr.assign (n + 1, 0);
+    for (octave_idx_type j = 0; j < n; j++)
+      for (octave_idx_type i = cidx[j]; i < cidx[j+1]; i++)
+        {
+          if (ridx[i] == j)
+            m_diag[j] = data[i];
+          else
+            m_rptr[ridx[i]+1]++;
+        }
+
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        if (m_diag[i] == 0.0)
+          return false;
+
+        m_rptr[i+1] += m_rptr[i];
+      }
+
+    m_cols.resize (m_rptr[n]);
+    m_vals.resize (m_rptr[n]);
+    std::vector<octave_idx_type> next (m_rptr.begin (), m_rptr.end () - 1);
+    for (octave_idx_type j = 0; j < n; j++)
+      for (octave_idx_type i = cidx[j]; i < cidx[j+1]; i++)
+        if (ridx[i] != j)
+          {
+            octave_idx_type k = next[ridx[i]]++;
+            m_cols[k] = j;
+            m_vals[k] = data[i];
+          }
+
+    std::vector<octave_idx_type> level (n);
+    for (octave_idx_type ii = 0; ii < n; ii++)
+      {
+        octave_idx_type i = (lower ? ii : n - 1 - ii);
+        octave_idx_type lev = 0;
+        for (octave_idx_type k = m_rptr[i]; k < m_rptr[i+1]; k++)
+          lev = std::max (lev, level[m_cols[k]] + 1);
+        level[i] = lev;
+      }
+
+    m_nlevels = sparse_level_order (n, level.data (), m_lptr, m_order);
+    m_nt = sparse_level_nthreads (nnz, n, m_nlevels);
+
+    return m_nt > 1;
+  }
+
+  // X = M \ B.
+
+  void solve (const ColumnVector& b, ColumnVector& x) const
+  {
+    x.resize (b.numel ());
+
+    const double *bv = b.data ();
+    double *xv = x.fortran_vec ();
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel num_threads (m_nt)
+#endif
+    for (octave_idx_type l = 0; l < m_nlevels; l++)
+      {
+#if defined (HAVE_OPENMP)
+#  pragma omp for schedule (static)
+#endif
+        for (octave_idx_type k = m_lptr[l]; k < m_lptr[l+1]; k++)
+          {
+            octave_idx_type i = m_order[k];
+            double tmp = bv[i];
+            for (octave_idx_type p = m_rptr[i]; p < m_rptr[i+1]; p++)
+              tmp -= m_vals[p] * xv[m_cols[p]];
+            xv[i] = tmp / m_diag[i];
+          }
+      }
+  }
+
+private:
+
+  int m_nt;
+  octave_idx_type m_nlevels;
+
+  // Rows of each level.
+  std::vector<octave_idx_type> m_lptr;
+  std::vector<octave_idx_type> m_order;
+
+  // Off-diagonal entries by rows, and the diagonal.
+  std::vector<octave_idx_type> m_rptr;
+  std::vector<octave_idx_type> m_cols;
+  std::vector<double> m_vals;
+  std::vector<double> m_diag;
+};
+
+// Set by pcg_singular_handler if a solve with a preconditioner finds it
+// singular to machine precision.  pcg.m detected this by turning the
+// Octave:singular-matrix warning into an error.
+
+static bool pcg_singular = false;
+
+static void
+pcg_singular_handler (double)
+{
+  pcg_singular = true;
+}
+
+// Preconditioner M1 or M2 of pcg, applied as M \ x.  The matrix type is
+// determined on first use and then kept, so the structure of M (for example
+// the triangular factors returned by ichol and ilu) is only probed once
+// instead of in every iteration.  Large sparse triangular preconditioners
+// are then solved with a level schedule.  Diagonal preconditioners are
+// applied like mldivide does, treating zeros on the diagonal as zero.
+
+class pcg_precond
+{
+public:
+
+  pcg_precond (const octave_value& m)
+    : m_empty (m.isempty ()), m_sparse (m.issparse ()),
+      m_diag (m.is_diag_matrix ()), m_sm (), m_fm (), m_d (), m_type (),
+      m_levels_checked (false), m_use_levels (false), m_levels ()
+  {
+    if (m_empty)
+      return;
+
+    if (m_sparse)
+      m_sm = m.sparse_matrix_value ();
+    else if (m_diag)
+      m_d = m.diag_matrix_value ().extract_diag ();
+    else
+      m_fm = m.matrix_value ();
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (pcg_precond)
+
+  ~pcg_precond () = default;
+
+  // Y = M \ X.  Return false if M is singular to machine precision.
+
+  bool apply (const ColumnVector& x, ColumnVector& y)
+  {
+    if (m_empty)
+      {
+        y = x;
+        return true;
+      }
+
+    if (m_use_levels)
+      {
+        m_levels.solve (x, y);
+        return true;
+      }
+
+    if (m_diag)
+      {
+        octave_idx_type n = x.numel ();
+
+        y.resize (n);
+
+        const double *dv = m_d.data ();
+        const double *xv = x.data ();
+        double *yv = y.fortran_vec ();
+
+        for (octave_idx_type i = 0; i < n; i++)
+          yv[i] = (dv[i] != 0.0 ? xv[i] / dv[i] : 0.0);
+
+        return true;
+      }
+
+    octave_idx_type info = 0;
+    double rcond = 0.0;
+
+    // The handler also suppresses the warning for a singular matrix.
+    // Without the fallback, a singular M is not solved in the least
+    // squares sense.
+    pcg_singular = false;
+
+    Matrix tmp;
+    if (m_sparse)
+      tmp = m_sm.solve (m_type, Matrix (x), info, rcond,
+                        pcg_singular_handler, false);
+    else
+      tmp = m_fm.solve (m_type, Matrix (x), info, rcond,
+                        pcg_singular_handler, false);
+
+    if (pcg_singular || info == -2)
+      return false;
+
+    y = tmp.column (0);
+
+    if (m_sparse && ! m_levels_checked)
+      {
+        m_levels_checked = true;
+
+        int typ = m_type.type (false);
+        if (typ == MatrixType::Lower || typ == MatrixType::Upper)
+          m_use_levels = m_levels.init (m_sm, typ == MatrixType::Lower);
+      }
+
+    return true;
+  }
+
+private:
+
+  bool m_empty;
+  bool m_sparse;
+  bool m_diag;
+
+  SparseMatrix m_sm;
+  Matrix m_fm;
+
+  // Diagonal of a diagonal M.
+  ColumnVector m_d;
+
+  MatrixType m_type;
+
+  bool m_levels_checked;
+  bool m_use_levels;
+  pcg_tri_levels m_levels;
+};
+
+// Preconditioned conjugate gradient iteration of pcg.m.  The vector updates
+// of one iteration are fused into single loops over preallocated vectors.
+// See pcg.m for the meaning of the returned values.
+
+template <typename MT>
+static octave_value_list
+pcg_iterate (const MT& a, const ColumnVector& b, double tol,
+             octave_idx_type maxit, pcg_precond& m1, pcg_precond& m2,
+             const ColumnVector& x0)
+{
+  const octave_idx_type n = b.numel ();
+  const double eps = std::numeric_limits<double>::epsilon ();
+
+  double b_norm = xnorm (b);
+
+  ColumnVector x (x0);
+  ColumnVector x_min (x0);
+  ColumnVector r (n);
+  ColumnVector p (n, 0.0);
+  ColumnVector w (n);
+  ColumnVector y, z;
+
+  ColumnVector resvec (maxit + 1, 0.0);
+
+  double *xv = x.fortran_vec ();
+  double *rv = r.fortran_vec ();
+  double *pv = p.fortran_vec ();
+  const double *bv = b.data ();
+
+  pcg_apply (a, x, w);
+  const double *wv = w.data ();
+  for (octave_idx_type i = 0; i < n; i++)
+    rv[i] = bv[i] - wv[i];
+
+  resvec(0) = xnorm (r);
+
+  octave_idx_type iter = 2;
+  octave_idx_type iter_min = 0;
+  int flag = 1;
+  double alpha = 1.0;
+  double old_tau = 1.0;
+
+  while (resvec(iter-2) > tol * b_norm && iter < maxit)
+    {
+      octave_quit ();
+
+      // M1 and M2 don't change, so a singular preconditioner is always
+      // detected in the first iteration.  Like pcg.m, don't apply M2 if M1
+      // is singular.
+      if (! (m1.apply (r, y) && m2.apply (y, z)))
+        {
+          flag = 2;
+          break;
+        }
+
+      const double *zv = z.data ();
+
+      double tau = 0.0;
+      for (octave_idx_type i = 0; i < n; i++)
+        tau += zv[i] * rv[i];
+
+      double beta = tau / old_tau;
+      old_tau = tau;
+
+      for (octave_idx_type i = 0; i < n; i++)
+        pv[i] = zv[i] + beta * pv[i];
+
+      pcg_apply (a, p, w);
+      wv = w.data ();
+
+      double den = 0.0;
+      for (octave_idx_type i = 0; i < n; i++)
+        den += pv[i] * wv[i];
+
+      alpha = tau / den;
+
+      // A is probably not positive definite.
+      if (0 >= std::abs (tau) * tol || tau <= 0
+          || 0 >= std::abs (den) * tol || den <= 0)
+        {
+          flag = 4;
+          break;
+        }
+
+      // Update iterate and residual, accumulating the norms needed for
+      // the convergence and stagnation tests.
+      double r_sq = 0.0;
+      double dx_sq = 0.0;
+      double x_sq = 0.0;
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          double xi = xv[i] + alpha * pv[i];
+          double dx = xi - xv[i];
+          xv[i] = xi;
+          rv[i] -= alpha * wv[i];
+
+          r_sq += rv[i] * rv[i];
+          dx_sq += dx * dx;
+          x_sq += xi * xi;
+        }
+
+      resvec(iter-1) = std::sqrt (r_sq);
+
+      if (resvec(iter-1) <= resvec(iter_min))
+        {
+          std::copy_n (xv, n, x_min.fortran_vec ());
+          iter_min = iter - 1;
+        }
+
+      iter++;
+
+      if (std::sqrt (dx_sq) <= eps * std::sqrt (x_sq))
+        {
+          flag = 3;
+          break;
+        }
+    }
+
+  return ovl (x_min, flag, resvec, iter, iter_min);
+}
+
+DEFUN (__pcg__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{x_min}, @var{flag}, @var{resvec}, @var{iter}, @var{iter_min}] =} __pcg__ (@var{A}, @var{b}, @var{tol}, @var{maxit}, @var{M1}, @var{M2}, @var{x0})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 7)
+    print_usage ();
+
+  ColumnVector b = args(1).column_vector_value ();
+  double tol = args(2).double_value ();
+  octave_idx_type maxit = args(3).idx_type_value ();
+  ColumnVector x0 = args(6).column_vector_value ();
+
+  if (maxit < 2)
+    error ("__pcg__: MAXIT must be at least 2");
+
+  if (args(0).rows () != b.numel () || args(0).columns () != b.numel ()
+      || x0.numel () != b.numel ())
+    error ("__pcg__: dimension mismatch");
+
+  pcg_precond m1 (args(4));
+  pcg_precond m2 (args(5));
+
+  if (args(0).issparse ())
+    return pcg_iterate (pcg_sparse (args(0).sparse_matrix_value ()), b, tol,
+                        maxit, m1, m2, x0);
+  else if (args(0).is_diag_matrix ())
+    return pcg_iterate (args(0).diag_matrix_value (), b, tol, maxit,
+                        m1, m2, x0);
+  else
+    return pcg_iterate (args(0).matrix_value (), b, tol, maxit,
+                        m1, m2, x0);
+}
+
+/*
+## Test input validation
+%!error <Invalid call> __pcg__ (1, 1, 1e-6, 10, [], [])
+%!error <dimension mismatch> __pcg__ (speye (3), ones (2, 1), 1e-6, 10, [], [], zeros (2, 1))
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -27,11 +27,14 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <iomanip>
 
 #include "filepos-wrappers.h"
+#include "unistd-wrappers.h"
 
 #include "c-file-ptr-stream.h"
+#include "gzfstream.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -210,7 +213,21 @@ c_zfile_ptr_buf::overflow (int_type c)
 c_zfile_ptr_buf::int_type
 c_zfile_ptr_buf::underflow_common (bool bump)
 {
-  if (m_f)
+  if (m_index)
+    {
+      char c;
+
+      if (m_index->read (&c, 1) != 1)
+        return traits_type::eof ();
+
+      // Reading one byte never leaves the index output buffer, so stepping
+      // back is cheap.
+      if (! bump)
+        m_index->seek (m_index->tell () - 1);
+
+      return traits_type::to_int_type (c);
+    }
+  else if (m_f)
     {
       int_type c = gzgetc (m_f);
 
@@ -226,6 +243,10 @@ c_zfile_ptr_buf::underflow_common (bool bump)
 c_zfile_ptr_buf::int_type
 c_zfile_ptr_buf::pbackfail (int_type c)
 {
+  if (m_index)
+    return ((c != traits_type::eof () && m_index->seek (m_index->tell () - 1))
+            ? c : traits_type::not_eof (c));
+
   return ((c != traits_type::eof () && m_f)
           ? gzungetc (c, m_f) : traits_type::not_eof (c));
 }
@@ -242,7 +263,9 @@ c_zfile_ptr_buf::xsputn (const char *s, std::streamsize n)
 std::streamsize
 c_zfile_ptr_buf::xsgetn (char *s, std::streamsize n)
 {
-  if (m_f)
+  if (m_index)
+    return m_index->read (s, n);
+  else if (m_f)
     return gzread (m_f, s, n);
   else
     return 0;
@@ -262,6 +285,111 @@ c_zfile_ptr_buf::seekpos (std::streampos /* offset */, std::ios::openmode)
   return -1;
 }
 
+int
+c_zfile_ptr_buf::seek (off_t offset, int origin)
+{
+  if (! m_f)
+    return -1;
+
+  // Rewinding and moving forward don't need the index, which is built by
+  // decompressing the whole file.
+  if (! m_index && m_index_fd >= 0 && origin != SEEK_END)
+    {
+      off_t cur = gztell (m_f);
+      off_t pos = (origin == SEEK_CUR ? cur + offset : offset);
+
+      if (cur >= 0 && pos == 0)
+        return gzrewind (m_f) == 0 ? 0 : -1;
+      else if (cur >= 0 && pos >= cur)
+        return skip (pos - cur) ? 0 : -1;
+    }
+
+  // gzseek can only move backward by decompressing again from the start
+  // of the file and cannot seek relative to the end at all.
+  if (m_index || init_seek_index ())
+    {
+      off_t pos = offset;
+
+      if (origin == SEEK_CUR)
+        pos += m_index->tell ();
+      else if (origin == SEEK_END)
+        pos += m_index->size ();
+
+      return m_index->seek (pos) ? 0 : -1;
+    }
+
+  return gzseek (m_f, offset, origin) >= 0 ? 0 : -1;
+}
+
+off_t
+c_zfile_ptr_buf::tell ()
+{
+  if (m_index)
+    return m_index->tell ();
+
+  return m_f ? gztell (m_f) : -1;
+}
+
+// Move forward N bytes by reading, unlike gzseek, which succeeds for
+// positions beyond the end of the data.  On failure, the position is
+// unchanged.
+
+bool
+c_zfile_ptr_buf::skip (off_t n)
+{
+  off_t orig_pos = gztell (m_f);
+
+  char buf[16384];
+
+  while (n > 0)
+    {
+      off_t len = std::min (n, static_cast<off_t> (sizeof (buf)));
+
+      int nr = gzread (m_f, buf, static_cast<unsigned> (len));
+
+      if (nr <= 0)
+        {
+          gzseek (m_f, orig_pos, SEEK_SET);
+          return false;
+        }
+
+      n -= nr;
+    }
+
+  return true;
+}
+
+bool
+c_zfile_ptr_buf::init_seek_index ()
+{
+  if (m_index_fd < 0)
+    return false;
+
+  off_t pos = gztell (m_f);
+
+  // The index reads through a duplicate of the descriptor of m_f, which
+  // shares its file offset.
+  off_t fd_pos = octave_lseek_wrapper (m_index_fd, 0, SEEK_CUR);
+
+  gzindex *idx = new gzindex ();
+
+  if (pos < 0 || fd_pos < 0 || ! idx->open (m_index_fd) || ! idx->seek (pos))
+    {
+      // Not a gzipped file (gzread also reads uncompressed files) or
+      // unreadable.  Don't try again, and leave the file offset where
+      // gzread expects it.
+      delete idx;
+      if (fd_pos >= 0)
+        octave_lseek_wrapper (m_index_fd, fd_pos, SEEK_SET);
+      m_index_fd = -1;
+      return false;
+    }
+
+  m_index = idx;
+
+  return true;
+}
+
 int
 c_zfile_ptr_buf::sync ()
 {
@@ -287,6 +415,9 @@ c_zfile_ptr_buf::buf_close ()
 
   flush ();
 
+  delete m_index;
+  m_index = nullptr;
+
   if (m_f)
     {
       retval = m_cf (m_f);
@@ -35,6 +35,10 @@
 #  include <zlib.h>
 #endif
 
+#if defined (HAVE_ZLIB)
+class gzindex;
+#endif
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 class c_file_ptr_buf : public std::streambuf
@@ -159,7 +163,8 @@ public:
   c_zfile_ptr_buf () = delete;
 
   c_zfile_ptr_buf (gzFile f, close_fcn cf = file_close)
-    : std::streambuf (), m_f (f), m_cf (cf)
+    : std::streambuf (), m_f (f), m_cf (cf), m_index_fd (-1),
+      m_index (nullptr)
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (c_zfile_ptr_buf)
@@ -192,10 +197,18 @@ public:
 
   int file_number () const { return -1; }
 
-  int seek (off_t offset, int origin)
-  { return m_f ? gzseek (m_f, offset, origin) >= 0 : -1; }
+  int seek (off_t offset, int origin);
 
-  off_t tell () { return m_f ? gztell (m_f) : -1; }
+  off_t tell ();
+
+  // Allow seeking through a random access index of the file open on
+  // file descriptor FD.  The index is built the first time the stream is
+  // moved backward or relative to the end.  Only useful for streams that
+  // are opened read-only.
+  void enable_seek_index (int fd) { m_index_fd = fd; }
+
+  // Return true if seek fails for positions beyond the end of the data.
+  bool seek_checks_bounds () const { return m_index || m_index_fd >= 0; }
 
   void clear () { if (m_f) gzclearerr (m_f); }
 
@@ -207,9 +220,19 @@ protected:
 
   close_fcn m_cf;
 
+  // File descriptor used to build the seek index.
+  int m_index_fd;
+
+  // Once built, all reading goes through the index.
+  gzindex *m_index;
+
 private:
 
   int_type underflow_common (bool);
+
+  bool skip (off_t n);
+
+  bool init_seek_index ();
 };
 
 typedef c_file_ptr_stream<std::istream, gzFile, c_zfile_ptr_buf>
@@ -734,6 +734,23 @@ call_stack::backtrace_info () const
   return backtrace_info (curr_user_frame, true);
 }
 
+std::string
+call_stack::folded_stack () const
+{
+  std::string retval = "<top level>";
+
+  for (std::size_t i = 1; i < m_cs.size (); i++)
+    {
+      if (m_cs[i]->function ())
+        {
+          retval += ';';
+          retval += m_cs[i]->fcn_name ();
+        }
+    }
+
+  return retval;
+}
+
 octave_map
 call_stack::backtrace (octave_idx_type& curr_user_frame,
                        bool print_subfn) const
@@ -228,6 +228,11 @@ public:
 
   std::list<frame_info> backtrace_info () const;
 
+  // Names of the functions on the stack, outermost first and separated
+  // by semicolons, as in the folded stack format used for flame graphs.
+
+  std::string folded_stack () const;
+
   // The same as backtrace_info but in the form of a struct array
   // object that may be used in the interpreter.
 
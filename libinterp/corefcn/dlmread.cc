@@ -30,15 +30,23 @@
 #  include "config.h"
 #endif
 
+#include <array>
+#include <charconv>
+#include <cerrno>
 #include <clocale>
 #include <cmath>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <limits>
+#include <vector>
 
 #include "file-ops.h"
 #include "lo-ieee.h"
 #include "lo-sysdep.h"
+#include "nproc-wrapper.h"
 
 #include "defun.h"
 #include "interpreter.h"
@@ -167,6 +175,401 @@ parse_range_spec (const octave_value& range_spec,
   return stat;
 }
 
+// Fast path for files that contain nothing but real numbers.
+//
+// The file is read in large blocks which are cut at line boundaries.
+// Each block is split into line-aligned chunks that are parsed
+// concurrently and the results are then appended in order.  Only plain
+// decimal numbers and empty fields are accepted.  Anything else (complex
+// values, NA, Inf, text, etc.) makes the fast path give up so that the
+// general parser can handle the file with its usual semantics.
+
+static const std::streamsize dlm_block_size = 64 * 1024 * 1024;
+
+// Blocks smaller than this are parsed by a single thread.
+static const std::size_t dlm_min_chunk_size = 1024 * 1024;
+
+struct dlm_chunk
+{
+  std::vector<double> values;
+  std::vector<octave_idx_type> nfields;
+  bool ok = true;
+};
+
+static inline bool
+dlm_is_blank (char ch)
+{
+  return ch == ' ' || ch == '\t';
+}
+
+static bool
+dlm_parse_field (const char *beg, const char *end, double empty_value,
+                 double& val)
+{
+  while (beg < end && std::isspace (static_cast<unsigned char> (*beg)))
+    beg++;
+  while (end > beg && std::isspace (static_cast<unsigned char> (end[-1])))
+    end--;
+
+  if (beg == end)
+    {
+      val = empty_value;
+      return true;
+    }
+
+  for (const char *p = beg; p < end; p++)
+    {
+      char ch = *p;
+      if (! ((ch >= '0' && ch <= '9') || ch == '.' || ch == '+' || ch == '-'
+             || ch == 'e' || ch == 'E'))
+        return false;
+    }
+
+#if defined (__cpp_lib_to_chars)
+  // std::from_chars does not accept a leading '+'.  Skip it, but don't
+  // accept a second sign after it as strtod wouldn't either.
+  if (*beg == '+')
+    {
+      beg++;
+      if (beg < end && (*beg == '+' || *beg == '-'))
+        return false;
+    }
+
+  auto [ptr, ec] = std::from_chars (beg, end, val);
+
+  return ec == std::errc () && ptr == end;
+#else
+  // The character following the field is never part of a number (see the
+  // check of the separator in dlmread_fast), so strtod stops at END.
+  char *ptr;
+  errno = 0;
+  val = std::strtod (beg, &ptr);
+
+  return errno == 0 && ptr == end;
+#endif
+}
+
+// Parse the complete lines in [BEG, END).  On failure, CHUNK contains the
+// rows that were parsed before the offending line.
+
+static void
+dlm_parse_lines (const char *beg, const char *end,
+                 const std::array<bool, 256>& is_sep, bool ws_sep,
+                 double empty_value, dlm_chunk& chunk)
+{
+  const char *p = beg;
+
+  while (p < end)
+    {
+      const char *eol
+        = static_cast<const char *> (std::memchr (p, '\n', end - p));
+      if (! eol)
+        eol = end;
+
+      // Skip blank lines for compatibility.
+      const char *q = p;
+      while (q < eol && dlm_is_blank (*q))
+        q++;
+
+      if (q == eol)
+        {
+          p = eol + 1;
+          continue;
+        }
+
+      std::size_t row_start = chunk.values.size ();
+      octave_idx_type nf = 0;
+      double val;
+
+      if (ws_sep)
+        {
+          // Consecutive separators are treated as one.
+          while (q < eol)
+            {
+              const char *field = q;
+              while (q < eol && ! dlm_is_blank (*q))
+                q++;
+
+              if (! dlm_parse_field (field, q, empty_value, val))
+                {
+                  chunk.values.resize (row_start);
+                  chunk.ok = false;
+                  return;
+                }
+
+              chunk.values.push_back (val);
+              nf++;
+
+              while (q < eol && dlm_is_blank (*q))
+                q++;
+            }
+        }
+      else
+        {
+          const char *field = p;
+
+          while (true)
+            {
+              q = field;
+              while (q < eol && ! is_sep[static_cast<unsigned char> (*q)])
+                q++;
+
+              // Separator followed by EOL doesn't generate extra column
+              if (q == eol && q == field)
+                break;
+
+              if (! dlm_parse_field (field, q, empty_value, val))
+                {
+                  chunk.values.resize (row_start);
+                  chunk.ok = false;
+                  return;
+                }
+
+              chunk.values.push_back (val);
+              nf++;
+
+              if (q == eol)
+                break;
+
+              field = q + 1;
+            }
+        }
+
+      chunk.nfields.push_back (nf);
+
+      p = eol + 1;
+    }
+}
+
+// Return true and store the data in RESULT if the file could be read by
+// the fast path.  Rows R0 through R1 (zero-based) are read.
+
+static bool
+dlmread_fast (const std::string& fname, const std::string& sep_arg,
+              octave_idx_type r0, octave_idx_type r1, double empty_value,
+              Matrix& result)
+{
+  std::string sep = sep_arg;
+  bool ws_sep = false;
+
+  // Whitespace in an explicit separator has special semantics and
+  // separators that may be part of a number would confuse the field
+  // parser.  Leave these cases to the general parser.
+  if (sep.find_first_of (" \t\n0123456789.+-eE") != std::string::npos)
+    return false;
+
+  std::array<bool, 256> is_sep {};
+  for (unsigned char ch : sep)
+    is_sep[ch] = true;
+
+#if defined (OCTAVE_USE_WINDOWS_API)
+  std::wstring wname = octave::sys::u8_to_wstring (fname);
+  std::ifstream is (wname.c_str (), std::ios::in | std::ios::binary);
+#else
+  std::ifstream is (fname.c_str (), std::ios::in | std::ios::binary);
+#endif
+
+  if (! is)
+    return false;
+
+  int nthreads
+    = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+  octave_idx_type nrows_wanted = r1 - r0 + 1;
+  octave_idx_type nskip = r0;
+
+  std::vector<double> values;
+  std::vector<octave_idx_type> nfields;
+  octave_idx_type ncols = 0;
+
+  std::string buf;
+  std::string carry;
+  bool first_block = true;
+  bool done = false;
+
+  while (! done)
+    {
+      octave_quit ();
+
+      buf = carry;
+      std::size_t old_len = buf.size ();
+      buf.resize (old_len + dlm_block_size);
+      is.read (&buf[old_len], dlm_block_size);
+      buf.resize (old_len + is.gcount ());
+
+      bool at_eof = ! is;
+
+      // Strip UTF-8 Byte Order Mark (BOM)
+      if (first_block && r0 == 0 && buf.compare (0, 3, "\xEF\xBB\xBF") == 0)
+        buf.erase (0, 3);
+      first_block = false;
+
+      std::size_t len = buf.size ();
+      if (! at_eof)
+        {
+          std::size_t pos = buf.rfind ('\n');
+          if (pos == std::string::npos)
+            {
+              carry = buf;
+              continue;
+            }
+          len = pos + 1;
+        }
+
+      carry = buf.substr (len);
+
+      const char *beg = buf.data ();
+      const char *end = buf.data () + len;
+
+      // Skip the r0 leading lines
+      while (nskip > 0 && beg < end)
+        {
+          const char *eol
+            = static_cast<const char *> (std::memchr (beg, '\n', end - beg));
+          beg = (eol ? eol + 1 : end);
+          nskip--;
+        }
+
+      if (sep.empty ())
+        {
+          // Infer separator from the first non-blank line.
+          const char *p = beg;
+          while (p < end && sep.empty ())
+            {
+              const char *eol
+                = static_cast<const char *> (std::memchr (p, '\n', end - p));
+              if (! eol)
+                eol = end;
+
+              const char *q = p;
+              while (q < eol && dlm_is_blank (*q))
+                q++;
+
+              if (q < eol)
+                {
+                  while (q < eol && ! std::memchr (",:; \t", *q, 5))
+                    q++;
+
+                  if (q == eol || dlm_is_blank (*q))
+                    {
+                      sep = " \t";
+                      ws_sep = true;
+                    }
+                  else
+                    {
+                      sep = *q;
+                      is_sep[static_cast<unsigned char> (*q)] = true;
+                    }
+                }
+
+              p = eol + 1;
+            }
+        }
+
+      if (beg < end && ! sep.empty ())
+        {
+          // Split the block into line-aligned chunks.
+          std::size_t block_len = end - beg;
+          std::size_t nchunks = 1;
+          if (nthreads > 1 && block_len > dlm_min_chunk_size)
+            nchunks = std::min (static_cast<std::size_t> (4 * nthreads),
+                                block_len / dlm_min_chunk_size + 1);
+
+          std::vector<const char *> bounds (1, beg);
+          for (std::size_t k = 1; k < nchunks; k++)
+            {
+              const char *p = beg + k * (block_len / nchunks);
+              if (p <= bounds.back ())
+                continue;
+              const char *eol
+                = static_cast<const char *> (std::memchr (p, '\n', end - p));
+              if (! eol || eol + 1 >= end)
+                break;
+              bounds.push_back (eol + 1);
+            }
+          bounds.push_back (end);
+
+          octave_idx_type nc = bounds.size () - 1;
+          std::vector<dlm_chunk> chunks (nc);
+
+          // Exceptions, e.g., std::bad_alloc, must not leave the parallel
+          // region.  They are caught in the threads and rethrown afterwards.
+          std::exception_ptr err;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for schedule (dynamic) if (nc > 1) \
+  num_threads (nthreads)
+#endif
+          for (octave_idx_type k = 0; k < nc; k++)
+            {
+              try
+                {
+                  dlm_parse_lines (bounds[k], bounds[k+1], is_sep, ws_sep,
+                                   empty_value, chunks[k]);
+                }
+              catch (...)
+                {
+#if defined (HAVE_OPENMP)
+#  pragma omp critical (dlmread_parse_lines)
+#endif
+                  {
+                    if (! err)
+                      err = std::current_exception ();
+                  }
+                }
+            }
+
+          if (err)
+            std::rethrow_exception (err);
+
+          // Stitch the results together in order.
+          for (const auto& chunk : chunks)
+            {
+              std::size_t pos = 0;
+              for (octave_idx_type nf : chunk.nfields)
+                {
+                  if (static_cast<octave_idx_type> (nfields.size ())
+                      == nrows_wanted)
+                    break;
+
+                  values.insert (values.end (), chunk.values.begin () + pos,
+                                 chunk.values.begin () + pos + nf);
+                  nfields.push_back (nf);
+                  ncols = std::max (ncols, nf);
+                  pos += nf;
+                }
+
+              if (static_cast<octave_idx_type> (nfields.size ())
+                  == nrows_wanted)
+                {
+                  done = true;
+                  break;
+                }
+
+              if (! chunk.ok)
+                return false;
+            }
+        }
+
+      if (at_eof)
+        break;
+    }
+
+  octave_idx_type nrows = nfields.size ();
+
+  result = Matrix (nrows, ncols, empty_value);
+
+  double *pdata = result.fortran_vec ();
+  const double *pval = values.data ();
+  for (octave_idx_type i = 0; i < nrows; i++)
+    {
+      for (octave_idx_type j = 0; j < nfields[i]; j++)
+        pdata[i + j*nrows] = *pval++;
+    }
+
+  return true;
+}
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 DEFMETHOD (dlmread, interp, args, ,
@@ -221,13 +624,14 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 
   std::istream *input = nullptr;
   std::ifstream input_file;
+  std::string tname;
 
   if (args(0).is_string ())
     {
       // Filename.
       std::string fname (args(0).string_value ());
 
-      std::string tname = sys::file_ops::tilde_expand (fname);
+      tname = sys::file_ops::tilde_expand (fname);
 
       tname = find_data_file_in_load_path ("dlmread", tname);
 
@@ -343,6 +747,26 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
   unwind_action act
   ([old_locale] () { std::setlocale (LC_ALL, old_locale.c_str ()); });
 
+  if (! tname.empty ())
+    {
+      Matrix fast_data;
+
+      if (dlmread_fast (tname, sep, r0, r1, empty_value, fast_data))
+        {
+          octave_idx_type nr = fast_data.rows ();
+          octave_idx_type nc = fast_data.cols ();
+
+          // Clip selection indices to actual size of data
+          if (c1 >= nc)
+            c1 = nc - 1;
+
+          if (nr == 0 || c0 > c1)
+            return ovl (Matrix (0, 0));
+
+          return ovl (fast_data.extract (0, c0, nr - 1, c1));
+        }
+    }
+
   std::string line;
 
   // Skip the r0 leading lines
@@ -763,6 +1187,62 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 %!   unlink (file);
 %! end_unwind_protect
 
+## Large numeric file with ragged rows read by the fast path
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   x = reshape (1:30000, 3, []).' / 7;
+%!   fid = fopen (file, "wt");
+%!   fprintf (fid, "%.17g,%.17g,%.17g\n", x.');
+%!   fprintf (fid, "1,,2,3\n\n4\n");
+%!   fclose (fid);
+%!
+%!   data = dlmread (file);
+%!   assert (size (data), [10002, 4]);
+%!   assert (data(1:10000,1:3), x);
+%!   assert (data(10001:end,:), [1, 0, 2, 3; 4, 0, 0, 0]);
+%!   assert (dlmread (file, ",", [9999, 1, 10001, 2]), [x(end,2:3); 0, 2; 0, 0]);
+%!   assert (dlmread (file, "emptyvalue", -1)(end,:), [4, -1, -1, -1]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
+## Non-numeric field after many numeric lines
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   fid = fopen (file, "wt");
+%!   fprintf (fid, "%d %d\n", [1:5000; 1:5000]);
+%!   fprintf (fid, "NaN 3i\n");
+%!   fclose (fid);
+%!
+%!   data = dlmread (file);
+%!   assert (data(end,:), [NaN, 3i]);
+%!   assert (real (data(1:end-1,:)), [1:5000; 1:5000].');
+%!   assert (dlmread (file, "", [0, 0, 1, 1]), [1, 1; 2, 2]);
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
+## Fields with two signs are left to the general parser
+%!test
+%! file1 = tempname ();
+%! file2 = tempname ();
+%! unwind_protect
+%!   fid = fopen (file1, "wt");
+%!   fprintf (fid, "+1,+-1,3\n");
+%!   fclose (fid);
+%!   ## The NaN makes the fast parser give up on the second file.
+%!   fid = fopen (file2, "wt");
+%!   fprintf (fid, "+1,+-1,3\nNaN,0,0\n");
+%!   fclose (fid);
+%!
+%!   assert (dlmread (file1), dlmread (file2)(1,:));
+%! unwind_protect_cleanup
+%!   unlink (file1);
+%!   unlink (file2);
+%! end_unwind_protect
+
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -48,6 +48,10 @@
 // since they were last compiled?
 static int Vignore_function_time_stamp = 1;
 
+// Minimum time in seconds between two checks whether the file of a
+// function has changed.
+static double Vfunction_check_interval = 0.0;
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 octave_value
@@ -467,6 +471,18 @@ load_out_of_date_fcn (const std::string& file_name,
   return retval;
 }
 
+// Unless the current directory has changed, the file of a function need
+// not be checked again if it was checked less than
+// Vfunction_check_interval seconds ago.
+
+static bool
+checked_within_interval (const sys::time& tc)
+{
+  return (Vfunction_check_interval > 0 && tc > Vlast_chdir_time
+          && (sys::time ().double_value () - tc.double_value ()
+              < Vfunction_check_interval));
+}
+
 static bool
 out_of_date_check (octave_value& function,
                    const std::string& dispatch_type = "",
@@ -490,7 +506,7 @@ out_of_date_check (octave_value& function,
 
               bool relative = check_relative && fcn->is_relative ();
 
-              if (tc <= Vlast_prompt_time
+              if ((tc <= Vlast_prompt_time && ! checked_within_interval (tc))
                   || (relative && tc < Vlast_chdir_time))
                 {
                   bool clear_breakpoints = false;
@@ -1204,6 +1220,75 @@ recompiled.
   return retval;
 }
 
+DEFUN (function_check_interval, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} function_check_interval ()
+@deftypefnx {} {@var{old_val} =} function_check_interval (@var{new_val})
+Query or set the internal variable that specifies the minimum time in
+seconds between two checks whether the file that defines a function has
+changed.
+
+Octave checks the file of a function when it is called for the first time
+after a prompt was displayed, the load path was rehashed, or the current
+directory was changed.  Programs that run for a long time without
+displaying a prompt but call @code{addpath}, @code{rehash}, or similar
+functions frequently may spend a noticeable amount of time checking files.
+If @var{val} is positive, the file of a function is checked at most once
+every @var{val} seconds unless the current directory has changed.  Changes
+to the file or new functions that shadow it may then be noticed with a
+delay of up to @var{val} seconds.
+
+The default value is 0, which means that the file is checked every time.
+@seealso{ignore_function_time_stamp, rehash}
+@end deftypefn */)
+{
+  return set_internal_variable (Vfunction_check_interval, args, nargout,
+                                "function_check_interval", 0);
+}
+
+/*
+%!test
+%! old_val = function_check_interval (5);
+%! unwind_protect
+%!   assert (function_check_interval (), 5);
+%!   assert (function_check_interval (0.5), 5);
+%!   assert (function_check_interval (), 0.5);
+%! unwind_protect_cleanup
+%!   function_check_interval (old_val);
+%! end_unwind_protect
+
+%!test
+%! old_dir = pwd ();
+%! old_val = function_check_interval (3600);
+%! tmp_dir = tempname ();
+%! mkdir (tmp_dir);
+%! unwind_protect
+%!   cd (tmp_dir);
+%!   fid = fopen ("__fci_test__.m", "w");
+%!   fprintf (fid, "function r = __fci_test__ ()\n  r = 1;\nend\n");
+%!   fclose (fid);
+%!   assert (__fci_test__ (), 1);
+%!   pause (1.1);
+%!   fid = fopen ("__fci_test__.m", "w");
+%!   fprintf (fid, "function r = __fci_test__ ()\n  r = 2;\nend\n");
+%!   fclose (fid);
+%!   rehash ();
+%!   assert (__fci_test__ (), 1);
+%!   function_check_interval (0);
+%!   rehash ();
+%!   assert (__fci_test__ (), 2);
+%! unwind_protect_cleanup
+%!   cd (old_dir);
+%!   function_check_interval (old_val);
+%!   clear __fci_test__;
+%!   confirm_recursive_rmdir (false, "local");
+%!   rmdir (tmp_dir, "s");
+%! end_unwind_protect
+
+## Test input validation
+%!error <argument must be greater than 0> function_check_interval (-1)
+*/
+
 /*
 %!shared old_state
 %! old_state = ignore_function_time_stamp ();
@@ -799,6 +799,71 @@ beginning of the file specified by file descriptor @var{fid}.
   return ovl (os.tell ());
 }
 
+/*
+%!testif HAVE_ZLIB
+%! f = [tempname() ".gz"];
+%! unwind_protect
+%!   fid = fopen (f, "wz");
+%!   fwrite (fid, mod (0:99999, 251), "uint8");
+%!   fclose (fid);
+%!   fid = fopen (f, "rz");
+%!   assert (fseek (fid, 0, "eof"), 0);
+%!   assert (ftell (fid), 100000);
+%!   assert (fseek (fid, 50000, "bof"), 0);
+%!   assert (fread (fid, [1, 3], "uint8"), mod (50000:50002, 251));
+%!   assert (fseek (fid, -10, "cof"), 0);
+%!   assert (ftell (fid), 49993);
+%!   assert (fread (fid, 1, "uint8"), mod (49993, 251));
+%!   assert (fseek (fid, 1, "eof"), -1);
+%!   assert (ftell (fid), 49994);
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Rewinding and moving forward work without the index
+%!testif HAVE_ZLIB
+%! f = [tempname() ".gz"];
+%! unwind_protect
+%!   fid = fopen (f, "wz");
+%!   fwrite (fid, mod (0:9999, 251), "uint8");
+%!   fclose (fid);
+%!   fid = fopen (f, "rz");
+%!   assert (fseek (fid, 100, "bof"), 0);
+%!   assert (fseek (fid, 100, "cof"), 0);
+%!   assert (fread (fid, 1, "uint8"), mod (200, 251));
+%!   assert (fseek (fid, 10000, "bof"), -1);
+%!   assert (ftell (fid), 201);
+%!   frewind (fid);
+%!   assert (ftell (fid), 0);
+%!   assert (fread (fid, 2, "uint8"), [0; 1]);
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## The index reads the open file, even after a change of directory
+%!testif HAVE_ZLIB
+%! d = tempname ();
+%! mkdir (d);
+%! olddir = pwd ();
+%! unwind_protect
+%!   cd (d);
+%!   fid = fopen ("data.gz", "wz");
+%!   fwrite (fid, mod (0:9999, 251), "uint8");
+%!   fclose (fid);
+%!   fid = fopen ("data.gz", "rz");
+%!   cd (olddir);
+%!   assert (fseek (fid, -1, "eof"), 0);
+%!   assert (fread (fid, 1, "uint8"), mod (9999, 251));
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   cd (olddir);
+%!   confirm_recursive_rmdir (false, "local");
+%!   rmdir (d, "s");
+%! end_unwind_protect
+*/
+
 static octave_value_list
 printf_internal (interpreter& interp, const std::string& who,
                  const octave_value_list& args, int nargout)
@@ -1754,6 +1819,22 @@ as the name of the function when reporting errors.
 %! unlink (f);
 %! assert (c, {[1;3], [2;4]});
 
+## Read a file in batches, reusing and then changing the format
+%!test
+%! f = tempname ();
+%! fid = fopen (f, "w+");
+%! fprintf (fid, "%d,%d\n", [1:1200; 1201:2400]);
+%! fprintf (fid, "a,b\n");
+%! fseek (fid, 0, "bof");
+%! c1 = textscan (fid, "%f %f", 600, "delimiter", ",");
+%! c2 = textscan (fid, "%f %f", 600, "delimiter", ",");
+%! c3 = textscan (fid, "%s %s", "delimiter", ",");
+%! fclose (fid);
+%! unlink (f);
+%! assert (c1, {(1:600).', (1201:1800).'});
+%! assert (c2, {(601:1200).', (1801:2400).'});
+%! assert (c3, {{"a"}, {"b"}});
+
 ## Check number of lines read, with multiple delimiters
 %!test
 %! f = tempname ();
@@ -45,16 +45,27 @@
 
 #if defined (HAVE_ZLIB)
 
+// For std::min, std::upper_bound.
+#include <algorithm>
 // For strcpy, strcat, strlen (mode strings).
 #include <cstring>
 // For BUFSIZ.
 #include <cstdio>
 
+#include "filepos-wrappers.h"
+#include "unistd-wrappers.h"
+
 // Internal buffer sizes (default and "unbuffered" versions)
 #define STASHED_CHARACTERS 16
 #define BIGBUFSIZE (256 * 1024 + STASHED_CHARACTERS)
 #define SMALLBUFSIZE 1
 
+// Spacing of gzindex access points in uncompressed bytes, size of the
+// deflate history window, and size of the gzindex I/O buffers
+#define GZINDEX_SPAN (1024 * 1024)
+#define GZINDEX_WINSIZE 32768
+#define GZINDEX_CHUNK (128 * 1024)
+
 // Default constructor
 gzfilebuf::gzfilebuf ()
   : m_file(nullptr), m_io_mode(std::ios_base::openmode(0)), m_own_fd(false),
@@ -103,6 +114,8 @@ gzfilebuf::open (const char *name, std::ios_base::openmode mode)
   if ((m_file = gzopen (name, char_mode)) == nullptr)
     return nullptr;
 
+  this->set_zlib_buffer ();
+
   // On success, allocate internal buffer and set flags
   this->enable_buffer ();
   m_io_mode = mode;
@@ -130,6 +143,8 @@ gzfilebuf::attach (int fd, std::ios_base::openmode mode)
   if ((m_file = gzdopen (fd, char_mode)) == nullptr)
     return nullptr;
 
+  this->set_zlib_buffer ();
+
   // On success, allocate internal buffer and set flags
   this->enable_buffer ();
   m_io_mode = mode;
@@ -159,6 +174,19 @@ gzfilebuf::close ()
   return retval;
 }
 
+// Size zlib's internal buffers like the stream buffer
+void
+gzfilebuf::set_zlib_buffer ()
+{
+  // By default zlib reads and inflates in 8 KiB pieces, so every underflow
+  // of the (much larger) stream buffer would take several trips through
+  // zlib.  gzbuffer must be called before the first read or write.
+#if ZLIB_VERNUM >= 0x1240
+  if (m_buffer_size > SMALLBUFSIZE)
+    gzbuffer (m_file, static_cast<unsigned> (m_buffer_size));
+#endif
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 // Convert int open mode to mode string
@@ -520,6 +548,320 @@ gzfilebuf::seekpos (pos_type sp, std::ios_base::openmode)
   return ret;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Default constructor
+gzindex::gzindex ()
+  : m_file(nullptr), m_strm(), m_strm_init(false), m_raw(false),
+    m_at_end(true), m_points(), m_size(0), m_in(), m_buf(), m_buf_pos(0),
+    m_buf_len(0), m_buf_next(0)
+{ }
+
+// Destructor
+gzindex::~gzindex ()
+{
+  this->close ();
+}
+
+// Build index of open gzipped file
+bool
+gzindex::open (int fd)
+{
+  // Fail if file already open
+  if (this->is_open ())
+    return false;
+
+  int dup_fd = octave_dup_wrapper (fd);
+  if (dup_fd < 0)
+    return false;
+
+  if ((m_file = fdopen (dup_fd, "rb")) == nullptr)
+    {
+      octave_close_wrapper (dup_fd);
+      return false;
+    }
+
+  m_in.resize (GZINDEX_CHUNK);
+  m_buf.resize (GZINDEX_CHUNK);
+
+  // Decompress everything once from the start of the file, then position
+  // at start of data
+  off_t orig_pos = octave_ftello_wrapper (m_file);
+  if (orig_pos < 0 || octave_fseeko_wrapper (m_file, 0, SEEK_SET) != 0
+      || ! this->build ()
+      || (! m_points.empty () && ! this->start_at (m_points.front ())))
+    {
+      // Leave the shared file offset where the caller had it
+      if (orig_pos >= 0)
+        octave_fseeko_wrapper (m_file, orig_pos, SEEK_SET);
+      this->close ();
+      return false;
+    }
+
+  return true;
+}
+
+// Close file and discard index
+void
+gzindex::close ()
+{
+  if (m_strm_init)
+    inflateEnd (&m_strm);
+  m_strm_init = false;
+
+  if (m_file)
+    std::fclose (m_file);
+  m_file = nullptr;
+
+  m_points.clear ();
+  m_size = 0;
+  m_at_end = true;
+  m_buf_pos = 0;
+  m_buf_len = 0;
+  m_buf_next = 0;
+}
+
+// Refill input buffer from file if it is empty
+bool
+gzindex::fill_input ()
+{
+  if (m_strm.avail_in > 0)
+    return true;
+
+  std::size_t n = std::fread (m_in.data (), 1, m_in.size (), m_file);
+  m_strm.next_in = m_in.data ();
+  m_strm.avail_in = static_cast<uInt> (n);
+
+  return n > 0;
+}
+
+// Prepare for next gzip member after the end of a deflate stream.  Like
+// gzread, trailing garbage after the last member is ignored.
+bool
+gzindex::next_member ()
+{
+  // Raw inflate leaves the gzip trailer (CRC-32 and length) unread
+  if (m_raw)
+    {
+      uInt skip = 8;
+      while (skip > 0)
+        {
+          if (! this->fill_input ())
+            return false;
+          uInt n = std::min (skip, m_strm.avail_in);
+          m_strm.next_in += n;
+          m_strm.avail_in -= n;
+          skip -= n;
+        }
+    }
+
+  // Check for gzip magic bytes, making sure both are in the buffer
+  if (! this->fill_input () || m_strm.next_in[0] != 0x1f)
+    return false;
+  if (m_strm.avail_in < 2)
+    {
+      m_in[0] = m_strm.next_in[0];
+      std::size_t n = std::fread (m_in.data () + 1, 1, m_in.size () - 1,
+                                  m_file);
+      m_strm.next_in = m_in.data ();
+      m_strm.avail_in = static_cast<uInt> (n + 1);
+      if (n == 0)
+        return false;
+    }
+  if (m_strm.next_in[1] != 0x8b)
+    return false;
+
+  m_raw = false;
+  return inflateReset2 (&m_strm, 31) == Z_OK;
+}
+
+// Decompress whole file once, recording access points
+bool
+gzindex::build ()
+{
+  // Circular buffer holding the most recent output
+  std::vector<unsigned char> window (GZINDEX_WINSIZE, 0);
+
+  m_strm = z_stream ();
+  if (inflateInit2 (&m_strm, 31) != Z_OK)
+    return false;
+  m_strm_init = true;
+  m_raw = false;
+
+  off_t totout = 0;
+  off_t last = 0;
+
+  for (;;)
+    {
+      // Premature end of file
+      if (! this->fill_input ())
+        return false;
+
+      if (m_strm.avail_out == 0)
+        {
+          m_strm.next_out = window.data ();
+          m_strm.avail_out = GZINDEX_WINSIZE;
+        }
+
+      // Z_BLOCK returns at the end of every deflate block header, which is
+      // where decompression can be restarted
+      uInt avail_out = m_strm.avail_out;
+      int ret = inflate (&m_strm, Z_BLOCK);
+      totout += avail_out - m_strm.avail_out;
+
+      if (ret == Z_STREAM_END)
+        {
+          if (this->next_member ())
+            continue;
+          break;
+        }
+      else if (ret != Z_OK)
+        return false;
+
+      // At a block boundary that is not the last block in the stream?
+      if ((m_strm.data_type & 128) && ! (m_strm.data_type & 64)
+          && (totout == 0 || totout - last > GZINDEX_SPAN))
+        {
+          access_point ap;
+          ap.m_out = totout;
+          ap.m_in = octave_ftello_wrapper (m_file) - m_strm.avail_in;
+          ap.m_bits = m_strm.data_type & 7;
+
+          // Unroll circular window so that it ends at the current output
+          std::size_t left = m_strm.avail_out;
+          ap.m_window.resize (GZINDEX_WINSIZE);
+          std::copy (window.begin () + (GZINDEX_WINSIZE - left), window.end (),
+                     ap.m_window.begin ());
+          std::copy (window.begin (), window.begin () + (GZINDEX_WINSIZE - left),
+                     ap.m_window.begin () + left);
+
+          m_points.push_back (std::move (ap));
+          last = totout;
+        }
+    }
+
+  m_size = totout;
+  return true;
+}
+
+// Restart decompression at access point
+bool
+gzindex::start_at (const access_point& ap)
+{
+  if (inflateReset2 (&m_strm, -15) != Z_OK)
+    return false;
+  m_raw = true;
+  m_at_end = false;
+  m_strm.avail_in = 0;
+
+  m_buf_pos = ap.m_out;
+  m_buf_len = 0;
+  m_buf_next = 0;
+
+  // The block may start in the middle of a byte
+  if (octave_fseeko_wrapper (m_file, ap.m_in - (ap.m_bits ? 1 : 0),
+                             SEEK_SET) != 0)
+    return false;
+  if (ap.m_bits)
+    {
+      int c = std::getc (m_file);
+      if (c == EOF
+          || inflatePrime (&m_strm, ap.m_bits, c >> (8 - ap.m_bits)) != Z_OK)
+        return false;
+    }
+
+  return inflateSetDictionary (&m_strm, ap.m_window.data (),
+                               ap.m_window.size ()) == Z_OK;
+}
+
+// Decompress next chunk of data into the output buffer
+bool
+gzindex::refill ()
+{
+  m_buf_pos += m_buf_len;
+  m_buf_len = 0;
+  m_buf_next = 0;
+
+  m_strm.next_out = m_buf.data ();
+  m_strm.avail_out = static_cast<uInt> (m_buf.size ());
+
+  while (! m_at_end && m_strm.avail_out > 0)
+    {
+      if (! this->fill_input ())
+        {
+          m_at_end = true;
+          break;
+        }
+
+      int ret = inflate (&m_strm, Z_NO_FLUSH);
+      if (ret == Z_STREAM_END)
+        m_at_end = ! this->next_member ();
+      else if (ret != Z_OK)
+        m_at_end = true;
+    }
+
+  m_buf_len = m_buf.size () - m_strm.avail_out;
+  return m_buf_len > 0;
+}
+
+// Move to position in uncompressed data
+bool
+gzindex::seek (off_t pos)
+{
+  if (! this->is_open () || pos < 0 || pos > m_size)
+    return false;
+
+  // Target already decompressed?
+  off_t buf_end = m_buf_pos + static_cast<off_t> (m_buf_len);
+  if (pos >= m_buf_pos && pos <= buf_end)
+    {
+      m_buf_next = pos - m_buf_pos;
+      return true;
+    }
+
+  // Nearest access point at or before target
+  auto ap = std::upper_bound (m_points.begin (), m_points.end (), pos,
+                              [] (off_t p, const access_point& pt)
+                              { return p < pt.m_out; });
+  if (ap == m_points.begin ())
+    return false;
+  --ap;
+
+  // Restart there unless continuing from the current position is closer
+  if ((pos < buf_end || ap->m_out > buf_end) && ! this->start_at (*ap))
+    return false;
+
+  while (pos > m_buf_pos + static_cast<off_t> (m_buf_len))
+    {
+      if (! this->refill ())
+        return false;
+    }
+
+  m_buf_next = pos - m_buf_pos;
+  return true;
+}
+
+// Read uncompressed data from current position
+std::streamsize
+gzindex::read (char *buf, std::streamsize n)
+{
+  std::streamsize nread = 0;
+
+  while (nread < n)
+    {
+      if (m_buf_next == m_buf_len && (m_at_end || ! this->refill ()))
+        break;
+
+      std::size_t k = std::min (static_cast<std::size_t> (n - nread),
+                                m_buf_len - m_buf_next);
+      std::copy_n (m_buf.data () + m_buf_next, k, buf + nread);
+      m_buf_next += k;
+      nread += k;
+    }
+
+  return nread;
+}
+
 // Default constructor initializes stream buffer
 gzifstream::gzifstream ()
   : std::istream (nullptr), m_sb ()
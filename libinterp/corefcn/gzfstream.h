@@ -40,7 +40,11 @@
 
 #if defined (HAVE_ZLIB)
 
+#include <cstdio>
 #include <iosfwd>
+#include <vector>
+
+#include <sys/types.h>
 
 #include "zlib.h"
 
@@ -215,6 +219,15 @@ private:
   void
   enable_buffer ();
 
+  /**
+   *  @brief  Size zlib's internal buffers to match the stream buffer.
+   *
+   *  Called right after the file is opened, so a buffer installed with
+   *  setbuf beforehand also determines how much zlib reads at a time.
+  */
+  void
+  set_zlib_buffer ();
+
   /**
    *  @brief  Destroy internal buffer.
    *
@@ -268,6 +281,153 @@ private:
   bool m_own_buffer;
 };
 
+/**
+ *  @brief  Random access index for gzipped files.
+ *
+ *  This class decompresses a gzipped file once and records an access point
+ *  (the compressed bit offset and the preceding 32 KiB of output) roughly
+ *  every megabyte of uncompressed data, following zran.c from the zlib
+ *  examples.  Later reads start decompressing from the nearest access point
+ *  instead of from the beginning of the file, so that seeking backward or
+ *  to the end of the data is cheap.  Concatenated gzip members are
+ *  supported.
+*/
+class gzindex
+{
+public:
+  //  Default constructor.
+  gzindex ();
+
+  OCTAVE_DISABLE_COPY_MOVE (gzindex)
+
+  //  Destructor.
+  ~gzindex ();
+
+  /**
+   *  @brief  Build index of an open gzipped file.
+   *  @param  fd  File descriptor of the file.
+   *  @return  True on success, false if the file could not be read or is
+   *           not a valid gzipped file.
+   *
+   *  The index reads from a duplicate of @a fd, so it refers to the same
+   *  file even if the file is renamed or replaced.  The duplicate shares
+   *  the file offset with @a fd.  It is restored on failure, but not on
+   *  success, after which @a fd should no longer be used for reading.
+   *  On success the read position is at the beginning of the
+   *  uncompressed data.
+  */
+  bool
+  open (int fd);
+
+  /**
+   *  @brief  Check if file is open.
+   *  @return  True if file is open.
+  */
+  bool
+  is_open () const { return (m_file != nullptr); }
+
+  /**
+   *  @brief  Close file and discard index.
+  */
+  void
+  close ();
+
+  /**
+   *  @brief  Size of the uncompressed data.
+   *  @return  Number of bytes.
+  */
+  off_t
+  size () const { return m_size; }
+
+  /**
+   *  @brief  Current position in the uncompressed data.
+   *  @return  Offset in bytes.
+  */
+  off_t
+  tell () const { return m_buf_pos + static_cast<off_t> (m_buf_next); }
+
+  /**
+   *  @brief  Move to a position in the uncompressed data.
+   *  @param  pos  Offset in bytes, between 0 and size().
+   *  @return  True on success.
+  */
+  bool
+  seek (off_t pos);
+
+  /**
+   *  @brief  Read uncompressed data from current position.
+   *  @param  buf  Destination buffer.
+   *  @param  n  Maximum number of bytes to read.
+   *  @return  Number of bytes read, 0 at end of data or on error.
+  */
+  std::streamsize
+  read (char *buf, std::streamsize n);
+
+private:
+
+  //  Location at which decompression can be restarted.
+  struct access_point
+  {
+    //  Offset in the uncompressed data.
+    off_t m_out;
+    //  Offset of the first complete byte in the compressed file.
+    off_t m_in;
+    //  Number of bits of the preceding byte that belong to the block.
+    int m_bits;
+    //  Last 32 KiB of uncompressed data before this point.
+    std::vector<unsigned char> m_window;
+  };
+
+  //  Decompress whole file once, recording access points.
+  bool
+  build ();
+
+  //  Refill input buffer from file if it is empty.
+  bool
+  fill_input ();
+
+  //  True if another gzip member follows the current one.
+  bool
+  next_member ();
+
+  //  Restart decompression at access point.
+  bool
+  start_at (const access_point& ap);
+
+  //  Decompress next chunk of data into the output buffer.
+  bool
+  refill ();
+
+  //  Underlying compressed file.
+  FILE *m_file;
+
+  //  Decompression state.
+  z_stream m_strm;
+  bool m_strm_init;
+
+  //  True if decompressing a raw deflate stream that was entered at an
+  //  access point (gzip trailer must then be skipped manually).
+  bool m_raw;
+
+  //  True when decompression reached the end of the data.
+  bool m_at_end;
+
+  //  Access points ordered by uncompressed offset.
+  std::vector<access_point> m_points;
+
+  //  Total size of uncompressed data.
+  off_t m_size;
+
+  //  Compressed input buffer.
+  std::vector<unsigned char> m_in;
+
+  //  Uncompressed output buffer, holding data starting at m_buf_pos.
+  std::vector<unsigned char> m_buf;
+  off_t m_buf_pos;
+  std::size_t m_buf_len;
+  std::size_t m_buf_next;
+};
+
 /**
  *  @brief  Gzipped file input stream class.
  *
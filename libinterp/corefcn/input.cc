@@ -915,14 +915,16 @@ class file_reader : public base_reader
 public:
 
   file_reader (interpreter& interp, FILE *f_arg)
-    : base_reader (interp), m_file (f_arg)
+    : base_reader (interp), m_file (f_arg), m_file_encoding ()
   {
     input_system& input_sys = interp.get_input_system ();
     m_encoding = input_sys.mfile_encoding ();
   }
 
   file_reader (interpreter& interp, FILE *f_arg, const std::string& enc)
-    : base_reader (interp), m_file (f_arg), m_encoding (enc) { }
+    : base_reader (interp), m_file (f_arg), m_encoding (enc),
+      m_file_encoding ()
+  { }
 
   std::string get_input (const std::string& prompt, bool& eof);
 
@@ -932,10 +934,16 @@ public:
 
 private:
 
+  // Lower case name of the encoding of the file.  It is determined when
+  // the first line is read instead of for every line.
+  const std::string& file_encoding ();
+
   FILE *m_file;
 
   std::string m_encoding;
 
+  std::string m_file_encoding;
+
   static const std::string s_in_src;
 };
 
@@ -1047,6 +1055,35 @@ terminal_reader::get_input (const std::string& prompt, bool& eof)
 
 const std::string file_reader::s_in_src ("file");
 
+const std::string&
+file_reader::file_encoding ()
+{
+  if (m_file_encoding.empty ())
+    {
+      std::string mfile_encoding;
+
+      if (m_encoding.empty ())
+        {
+          input_system& input_sys = m_interpreter.get_input_system ();
+          mfile_encoding = input_sys.mfile_encoding ();
+        }
+      else
+        mfile_encoding = m_encoding;
+
+      if (mfile_encoding.compare ("system") == 0)
+        {
+          m_file_encoding = octave_locale_charset_wrapper ();
+          // encoding identifiers should consist of ASCII only characters
+          std::transform (m_file_encoding.begin (), m_file_encoding.end (),
+                          m_file_encoding.begin (), ::tolower);
+        }
+      else
+        m_file_encoding = mfile_encoding;
+    }
+
+  return m_file_encoding;
+}
+
 std::string
 file_reader::get_input (const std::string& /*prompt*/, bool& eof)
 {
@@ -1056,26 +1093,7 @@ file_reader::get_input (const std::string& /*prompt*/, bool& eof)
 
   std::string src_str = fgets (m_file, eof);
 
-  std::string mfile_encoding;
-
-  if (m_encoding.empty ())
-    {
-      input_system& input_sys = m_interpreter.get_input_system ();
-      mfile_encoding = input_sys.mfile_encoding ();
-    }
-  else
-    mfile_encoding = m_encoding;
-
-  std::string encoding;
-  if (mfile_encoding.compare ("system") == 0)
-    {
-      encoding = octave_locale_charset_wrapper ();
-      // encoding identifiers should consist of ASCII only characters
-      std::transform (encoding.begin (), encoding.end (), encoding.begin (),
-                      ::tolower);
-    }
-  else
-    encoding = mfile_encoding;
+  const std::string& encoding = file_encoding ();
 
   if (encoding.compare ("utf-8") == 0)
     {
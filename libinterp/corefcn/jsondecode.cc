@@ -27,6 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <type_traits>
+#include <vector>
+
 #include "defun.h"
 #include "error.h"
 #include "errwarn.h"
@@ -131,10 +134,9 @@ static octave_value
 decode_numeric_array (const rapidjson::Value& val)
 {
   NDArray retval (dim_vector (val.Size (), 1));
-  octave_idx_type index = 0;
+  double *retval_data = retval.fortran_vec ();
   for (const auto& elem : val.GetArray ())
-    retval(index++) = elem.IsNull () ? octave_NaN
-                      : decode_number (elem).double_value ();
+    *retval_data++ = elem.IsNull () ? octave_NaN : elem.GetDouble ();
   return retval;
 }
 
@@ -156,12 +158,136 @@ static octave_value
 decode_boolean_array (const rapidjson::Value& val)
 {
   boolNDArray retval (dim_vector (val.Size (), 1));
-  octave_idx_type index = 0;
+  bool *retval_data = retval.fortran_vec ();
   for (const auto& elem : val.GetArray ())
-    retval(index++) = elem.GetBool ();
+    *retval_data++ = elem.GetBool ();
   return retval;
 }
 
+//! Checks whether a JSON array is a nested array of numbers (or of Booleans)
+//! with the same length for all sub-arrays at each level of nesting.  Such
+//! arrays can be decoded directly into an N-dimensional array.
+//!
+//! @param val JSON value that is guaranteed to be an array.
+//! @param depth Nesting level of @p val.
+//! @param dims Lengths of the arrays at each nesting level found so far.
+//! @param leaf_type 1 for numerical and 2 for Boolean elements, 0 if unknown.
+//!
+//! @return true if @p val can be decoded by @ref decode_regular_array.
+
+static bool
+is_regular_array (const rapidjson::Value& val, std::size_t depth,
+                  std::vector<octave_idx_type>& dims, int& leaf_type)
+{
+  octave_idx_type len = val.Size ();
+
+  if (len == 0)
+    return false;
+
+  if (depth == dims.size ())
+    {
+      // The first array at a new level must be the first visited leaf
+      // array or the first array containing arrays at that level.
+      if (leaf_type != 0)
+        return false;
+      dims.push_back (len);
+    }
+  else if (dims[depth] != len)
+    return false;
+
+  if (val[0].IsArray ())
+    {
+      for (const auto& elem : val.GetArray ())
+        if (! elem.IsArray ()
+            || ! is_regular_array (elem, depth + 1, dims, leaf_type))
+          return false;
+    }
+  else
+    {
+      // All leaf arrays must be at the deepest level.
+      if (depth + 1 != dims.size ())
+        return false;
+
+      for (const auto& elem : val.GetArray ())
+        {
+          int elem_type = (elem.IsNumber () || elem.IsNull () ? 1
+                           : elem.IsBool () ? 2 : 0);
+
+          if (elem_type == 0 || (leaf_type != 0 && elem_type != leaf_type))
+            return false;
+
+          leaf_type = elem_type;
+        }
+    }
+
+  return true;
+}
+
+template <typename T>
+static void
+fill_regular_array (const rapidjson::Value& val, T *data,
+                    octave_idx_type offset, octave_idx_type stride,
+                    const std::vector<octave_idx_type>& dims,
+                    std::size_t depth)
+{
+  octave_idx_type len = dims[depth];
+
+  if (depth + 1 == dims.size ())
+    {
+      for (const auto& elem : val.GetArray ())
+        {
+          if constexpr (std::is_same<T, bool>::value)
+            data[offset] = elem.GetBool ();
+          else
+            data[offset] = elem.IsNull () ? octave_NaN : elem.GetDouble ();
+          offset += stride;
+        }
+    }
+  else
+    {
+      for (const auto& elem : val.GetArray ())
+        {
+          fill_regular_array (elem, data, offset, stride * len, dims,
+                              depth + 1);
+          offset += stride;
+        }
+    }
+}
+
+//! Decodes a JSON array that was accepted by @ref is_regular_array directly
+//! into an NDArray or boolNDArray without creating intermediate values for
+//! the sub-arrays.  The element @c [i][j][k] is stored at index
+//! @c (i,j,k) of the result.
+//!
+//! @param val JSON value that is guaranteed to be a regular array.
+//! @param dims Lengths of the arrays at each nesting level.
+//! @param is_bool true if the elements are Booleans.
+//!
+//! @return @ref octave_value that contains the equivalent array of @p val.
+
+static octave_value
+decode_regular_array (const rapidjson::Value& val,
+                      const std::vector<octave_idx_type>& dims, bool is_bool)
+{
+  dim_vector array_dims;
+  array_dims.resize (dims.size ());
+  for (std::size_t i = 0; i < dims.size (); i++)
+    array_dims(i) = dims[i];
+
+  if (is_bool)
+    {
+      boolNDArray array (array_dims);
+      fill_regular_array (val, array.fortran_vec (), 0, 1, dims, 0);
+      return array;
+    }
+  else
+    {
+      NDArray array (array_dims);
+      fill_regular_array (val, array.fortran_vec (), 0, 1, dims, 0);
+      return array;
+    }
+}
+
 //! Decodes a JSON array that contains different types
 //! or string values only into a Cell.
 //!
@@ -292,6 +418,12 @@ static octave_value
 decode_array_of_arrays (const rapidjson::Value& val,
                         const octave::make_valid_name_options *options)
 {
+  // Fast path for nested arrays of numbers or Booleans
+  std::vector<octave_idx_type> dims;
+  int leaf_type = 0;
+  if (is_regular_array (val, 0, dims, leaf_type))
+    return decode_regular_array (val, dims, leaf_type == 2);
+
   // Some arrays should be decoded as NDArrays and others as cell arrays
   Cell cell = decode_string_and_mixed_array (val, options).cell_value ();
 
@@ -624,7 +756,9 @@ jsondecode ('@{"1": "one", "2": "two"@}', 'Prefix', 'm_')
   // problem in decoding JSON arrays as the output may be an array or a cell
   // and that doesn't only depend on the event (startArray) but also on the
   // types of the elements inside the array.
-  d.Parse <rapidjson::kParseNanAndInfFlag> (json.c_str ());
+  // The text is parsed in situ so that strings and object keys in the DOM
+  // refer to the (modified) copy of the input instead of being duplicated.
+  d.ParseInsitu <rapidjson::kParseNanAndInfFlag> (&json[0]);
 
   if (d.HasParseError ())
     error ("jsondecode: parse error at offset %u: %s\n",
@@ -44,6 +44,35 @@
 
 #if defined (HAVE_RAPIDJSON)
 
+//! Encodes a double value into a numerical JSON value.
+//!
+//! @param writer RapidJSON's writer that is responsible for generating JSON.
+//! @param value the value to encode.
+//! @param ConvertInfAndNaN @c bool that converts @c Inf and @c NaN to @c null.
+//!
+//! @b Example:
+//!
+//! @code{.cc}
+//! encode_double (writer, 7.5, true);
+//! @endcode
+
+template <typename T> void
+encode_double (T& writer, double value, const bool& ConvertInfAndNaN)
+{
+  // Detect floating point numbers which are actually integers by checking
+  // whether the number and the integer portion of the number are the same
+  // to within eps.
+  // FIXME: If value > 999999, MATLAB will encode it in scientific
+  // notation, but rapidJSON will output all digits.
+  if (fabs (trunc (value) - value) < std::numeric_limits<double>::epsilon ())
+    writer.Int64 (value);
+  // Possibly write NULL for non-finite values (-Inf, Inf, NaN, NA)
+  else if (ConvertInfAndNaN && ! octave::math::isfinite (value))
+    writer.Null ();
+  else
+    writer.Double (value);
+}
+
 //! Encodes a scalar Octave value into a numerical JSON value.
 //!
 //! @param writer RapidJSON's writer that is responsible for generating JSON.
@@ -62,23 +91,7 @@ encode_numeric (T& writer, const octave_value& obj,
                 const bool& ConvertInfAndNaN)
 {
   if (obj.isfloat ())
-    {
-      double value = obj.scalar_value ();
-
-      // Detect floating point numbers which are actually integers by checking
-      // whether the number and the integer portion of the number are the same
-      // to within eps.
-      // FIXME: If value > 999999, MATLAB will encode it in scientific
-      // notation, but rapidJSON will output all digits.
-      if (fabs (trunc (value) - value) < std::numeric_limits<double>::epsilon ())
-
-        writer.Int64 (value);
-      // Possibly write NULL for non-finite values (-Inf, Inf, NaN, NA)
-      else if (ConvertInfAndNaN && ! octave::math::isfinite (value))
-        writer.Null ();
-      else
-        writer.Double (value);
-    }
+    encode_double (writer, obj.scalar_value (), ConvertInfAndNaN);
   else if (obj.isinteger ())
     {
        if (obj.is_uint64_type ())
@@ -284,121 +297,95 @@ encode_cell (T& writer, const octave_value& obj, const bool& ConvertInfAndNaN)
   writer.EndArray ();
 }
 
+//! Encodes the elements of a numeric or logical array along one dimension
+//! into a JSON array, recursing into nested JSON arrays for the remaining
+//! dimensions.  The element @c (i,j,k) of the array becomes the element
+//! @c [i][j][k] of the JSON array.
+//!
+//! @param writer RapidJSON's writer that is responsible for generating JSON.
+//! @param data pointer to the elements of the array.
+//! @param dims dimensions of the array.
+//! @param dim dimension to encode at this level of recursion.
+//! @param offset index of the first element to encode.
+//! @param stride distance between consecutive elements along @p dim.
+//! @param ConvertInfAndNaN @c bool that converts @c Inf and @c NaN to @c null.
+//! @param is_logical @c bool that indicates if the array is logical.
+
+template <typename T> void
+encode_array_dim (T& writer, const double *data, const dim_vector& dims,
+                  int dim, octave_idx_type offset, octave_idx_type stride,
+                  const bool& ConvertInfAndNaN, bool is_logical)
+{
+  octave_idx_type len = dims(dim);
+
+  writer.StartArray ();
+
+  if (dim == dims.ndims () - 1)
+    {
+      for (octave_idx_type i = 0; i < len; i++, offset += stride)
+        {
+          if (is_logical)
+            writer.Bool (data[offset] != 0);
+          else
+            encode_double (writer, data[offset], ConvertInfAndNaN);
+        }
+    }
+  else
+    {
+      for (octave_idx_type i = 0; i < len; i++, offset += stride)
+        encode_array_dim (writer, data, dims, dim + 1, offset,
+                          stride * len, ConvertInfAndNaN, is_logical);
+    }
+
+  writer.EndArray ();
+}
+
 //! Encodes a numeric or logical Octave array into a JSON array
 //!
+//! Vectors, including N-dimensional arrays with only one non-singleton
+//! dimension, are encoded as flat JSON arrays.  Other arrays are encoded
+//! as nested JSON arrays with one level per dimension.  The elements are
+//! read directly from the array data.
+//!
 //! @param writer RapidJSON's writer that is responsible for generating JSON.
 //! @param obj numeric or logical Octave array.
 //! @param ConvertInfAndNaN @c bool that converts @c Inf and @c NaN to @c null.
-//! @param original_dims The original dimensions of the array being encoded.
-//! @param level The level of recursion for the function.
-//! @param is_logical optional @c bool that indicates if the array is logical.
 //!
 //! @b Example:
 //!
 //! @code{.cc}
 //! octave_value obj (NDArray ());
-//! encode_array (writer, obj,true);
+//! encode_array (writer, obj, true);
 //! @endcode
 
 template <typename T> void
-encode_array (T& writer, const octave_value& obj, const bool& ConvertInfAndNaN,
-              const dim_vector& original_dims, int level = 0,
-              bool is_logical = false)
+encode_array (T& writer, const octave_value& obj, const bool& ConvertInfAndNaN)
 {
-  NDArray array = obj.array_value ();
-  // is_logical is assigned at level 0.  I think this is better than changing
-  // many places in the code, and it makes the function more modular.
-  if (level == 0)
-    is_logical = obj.islogical ();
+  const NDArray array = obj.array_value ();
+  const dim_vector& dims = array.dims ();
+  const double *data = array.data ();
+  bool is_logical = obj.islogical ();
 
   if (array.isempty ())
     {
       writer.StartArray ();
       writer.EndArray ();
     }
-  else if (array.isvector ())
+  else if (array.isvector () || dims.num_ones () == dims.ndims () - 1)
     {
       writer.StartArray ();
       for (octave_idx_type i = 0; i < array.numel (); ++i)
         {
           if (is_logical)
-            encode_numeric (writer, bool (array(i)), ConvertInfAndNaN);
+            writer.Bool (data[i] != 0);
           else
-            encode_numeric (writer, array(i), ConvertInfAndNaN);
+            encode_double (writer, data[i], ConvertInfAndNaN);
         }
       writer.EndArray ();
     }
   else
-    {
-      octave_idx_type idx;
-      octave_idx_type ndims = array.ndims ();
-      const dim_vector& dims = array.dims ();
-
-      // In this case, we already have a vector. So,  we transform it to 2-D
-      // vector in order to be detected by "isvector" in the recursive call
-      if (dims.num_ones () == ndims - 1)
-        {
-          // Handle the special case when the input is a vector with more than
-          // 2 dimensions (e.g. ones ([1 1 1 1 1 6])). In this case, we don't
-          // add dimension brackets and treat it as if it is a vector
-          if (level != 0)
-            // Place an opening and a closing bracket (represents a dimension)
-            // for every dimension that equals 1 till we reach the 2-D vector
-            for (int i = level; i < ndims - 1; ++i)
-              writer.StartArray ();
-
-          encode_array (writer, array.as_row (), ConvertInfAndNaN,
-                        original_dims, level + 1, is_logical);
-
-          if (level != 0)
-            for (int i = level; i < ndims - 1; ++i)
-              writer.EndArray ();
-        }
-      else
-        {
-          // We place an opening and a closing bracket for each dimension
-          // that equals 1 to preserve the number of dimensions when decoding
-          // the array after encoding it.
-          if (original_dims (level) == 1)
-            {
-              writer.StartArray ();
-              encode_array (writer, array, ConvertInfAndNaN,
-                            original_dims, level + 1, is_logical);
-              writer.EndArray ();
-            }
-          else
-            {
-              for (idx = 0; idx < ndims; ++idx)
-                if (dims(idx) != 1)
-                  break;
-
-              // Create the dimensions that will be used to call "num2cell"
-              // We called "num2cell" to divide the array to smaller sub-arrays
-              // in order to encode it recursively.
-              // The recursive encoding is necessary to support encoding of
-              // higher-dimensional arrays.
-              RowVector conversion_dims;
-              conversion_dims.resize (ndims - 1);
-              for (octave_idx_type i = 0; i < idx; ++i)
-                conversion_dims(i) = i + 1;
-              for (octave_idx_type i = idx ; i < ndims - 1; ++i)
-                conversion_dims(i) = i + 2;
-
-              octave_value_list args (obj);
-              args.append (conversion_dims);
-
-              Cell sub_arrays = octave::Fnum2cell (args)(0).cell_value ();
-
-              writer.StartArray ();
-
-              for (octave_idx_type i = 0; i < sub_arrays.numel (); ++i)
-                encode_array (writer, sub_arrays(i), ConvertInfAndNaN,
-                              original_dims, level + 1, is_logical);
-
-              writer.EndArray ();
-            }
-        }
-    }
+    encode_array_dim (writer, data, dims, 0, 0, 1, ConvertInfAndNaN,
+                      is_logical);
 }
 
 //! Encodes any Octave object. This function only serves as an interface
@@ -423,7 +410,7 @@ encode (T& writer, const octave_value& obj, const bool& ConvertInfAndNaN)
     encode_numeric (writer, obj, ConvertInfAndNaN);
   else if (obj.isnumeric () || obj.islogical ())
     // Numeric and logical arrays.
-    encode_array (writer, obj, ConvertInfAndNaN, obj.dims ());
+    encode_array (writer, obj, ConvertInfAndNaN);
   else if (obj.is_string ())
     encode_string (writer, obj, obj.dims ());
   else if (obj.isstruct ())
@@ -127,6 +127,7 @@ COREFCN_SRC = \
   %reldir%/__isprimelarge__.cc \
   %reldir%/__lin_interpn__.cc \
   %reldir%/__magick_read__.cc \
+  %reldir%/__pcg__.cc \
   %reldir%/__pchip_deriv__.cc \
   %reldir%/__qp__.cc \
   %reldir%/amd.cc \
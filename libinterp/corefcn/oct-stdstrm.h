@@ -161,7 +161,12 @@ public:
                 const std::string& encoding = "utf-8",
                 c_zfile_ptr_buf::close_fcn cf = c_zfile_ptr_buf::file_close)
     : tstdiostream<c_zfile_ptr_buf, io_c_zfile_ptr_stream, gzFile>
-      (n, f, fid, m, ff, encoding, cf) { }
+      (n, f, fid, m, ff, encoding, cf)
+  {
+    // Files opened for reading only can be repositioned through an index.
+    if (m_stream && (m & std::ios::in) && ! (m & std::ios::out))
+      m_stream->rdbuf ()->enable_seek_index (fid);
+  }
 
   static stream
   create (const std::string& n, gzFile f = nullptr, int fid = 0,
@@ -175,6 +180,13 @@ public:
 
   OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (zstdiostream)
 
+  // Finding the end of a gzipped file means decompressing all of it.
+
+  bool seek_checks_bounds () const
+  {
+    return m_stream && m_stream->rdbuf ()->seek_checks_bounds ();
+  }
+
 protected:
 
   ~zstdiostream () = default;
@@ -1810,6 +1810,11 @@ public:
                      const octave_value_list& options,
                      octave_idx_type& read_count);
 
+  octave_value scan (std::istream& isp, textscan_format_list& fmt_list,
+                     octave_idx_type ntimes,
+                     const octave_value_list& options,
+                     octave_idx_type& read_count);
+
 private:
 
   friend class textscan_format_list;
@@ -2551,6 +2556,14 @@ textscan::scan (std::istream& isp, const std::string& fmt,
 {
   textscan_format_list fmt_list (fmt);
 
+  return scan (isp, fmt_list, ntimes, options, count);
+}
+
+octave_value
+textscan::scan (std::istream& isp, textscan_format_list& fmt_list,
+                octave_idx_type ntimes, const octave_value_list& options,
+                octave_idx_type& count)
+{
   parse_options (options, fmt_list);
 
   octave_value result = do_scan (isp, fmt_list, ntimes);
@@ -2591,7 +2604,9 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
                                  m_delim_len, 3});  // 3 for NaN and Inf
 
   // Next, choose a buffer size to avoid reading too much, or too often.
-  octave_idx_type buf_size = 4096;
+  // When reading to the end of the data, a larger buffer costs at most
+  // one buffer of read-ahead.
+  octave_idx_type buf_size = (ntimes == -1 ? 65536 : 4096);
   if (m_buffer_size)
     buf_size = m_buffer_size;
   else if (ntimes > 0)
@@ -2606,9 +2621,11 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
                         : m_delims),
                        max_lookahead, buf_size);
 
-  // Grow retval dynamically.  "size" is half the initial size
-  // (FIXME: Should we start smaller if ntimes is large?)
-  octave_idx_type size = ((ntimes < 8 && ntimes >= 0) ? ntimes : 1);
+  // Grow retval dynamically.  If the number of rows to read is known,
+  // allocate all of them at once (up to max_prealloc rows) instead of
+  // repeatedly doubling the size of every column.
+  static const octave_idx_type max_prealloc = 65536;
+  octave_idx_type size = 0;
   Array<octave_idx_type> row_idx (dim_vector (1, 2));
   row_idx(1) = 0;
 
@@ -2672,7 +2689,11 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
         {
           if (row == 0 || row >= size)
             {
-              size += (size+1);
+              octave_idx_type new_size = 2*size + 1;
+              if (ntimes > 0 && new_size < ntimes)
+                new_size = std::min (ntimes,
+                                     std::max (new_size, max_prealloc));
+              size = new_size;
               for (auto& col : out)
                 col = col.resize (dim_vector (size, 1), 0);
             }
@@ -5445,7 +5466,22 @@ base_stream::do_textscan (const std::string& fmt,
     {
       textscan scanner (who, encoding ());
 
-      retval = scanner.scan (*isp, fmt, ntimes, options, read_count);
+      // A format of "" is resolved by reading the first line of data and
+      // the parsed list is modified accordingly, so it can't be reused.
+      if (fmt.empty ())
+        retval = scanner.scan (*isp, fmt, ntimes, options, read_count);
+      else
+        {
+          if (! m_textscan_fmt_list || fmt != m_textscan_fmt)
+            {
+              m_textscan_fmt_list
+                = std::make_shared<textscan_format_list> (fmt);
+              m_textscan_fmt = fmt;
+            }
+
+          retval = scanner.scan (*isp, *m_textscan_fmt_list, ntimes, options,
+                                 read_count);
+        }
     }
 
   return retval;
@@ -6243,6 +6279,9 @@ stream::seek (off_t offset, int origin)
     {
       clearerr ();
 
+      if (m_rep->seek_checks_bounds ())
+        return m_rep->seek (offset, origin);
+
       // Find current position so we can return to it if needed.
       off_t orig_pos = m_rep->tell ();
 
@@ -61,6 +61,8 @@ class scanf_format_list;
 class printf_format_elt;
 class printf_format_list;
 
+class textscan_format_list;
+
 // Provide an interface for Octave streams.
 
 class OCTINTERP_API base_stream
@@ -74,7 +76,7 @@ public:
                const std::string& encoding = "utf-8")
     : m_mode (arg_md), m_flt_fmt (ff), m_encoding (encoding),
       m_conv_ostream (nullptr), m_fail (false), m_open_state (true),
-      m_errmsg ()
+      m_errmsg (), m_textscan_fmt (), m_textscan_fmt_list ()
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (base_stream)
@@ -88,6 +90,11 @@ public:
 
   virtual int seek (off_t offset, int origin) = 0;
 
+  // Return TRUE if seek fails for positions beyond the end of the
+  // stream, so that the end need not be found first.
+
+  virtual bool seek_checks_bounds () const { return false; }
+
   // Return current stream position.
 
   virtual off_t tell () = 0;
@@ -227,6 +234,13 @@ private:
   // Should contain error message if fail is TRUE.
   std::string m_errmsg;
 
+  // Format string and parsed format list of the last call to textscan.
+  // Repeated calls with the same format (e.g., reading a large file in
+  // batches) reuse the parsed list.
+  std::string m_textscan_fmt;
+
+  std::shared_ptr<textscan_format_list> m_textscan_fmt_list;
+
   // Functions that are defined for all input streams (input streams
   // are those that define is).
 
@@ -357,30 +357,19 @@ parse_options (regexp::opts& options, const octave_value_list& args,
     }
 }
 
+// Convert the matches RX_LST of a pattern in BUFFER to the output
+// arguments of regexp.  ARGS are the arguments of regexp, of which
+// the optional arguments select the order of the outputs.
+
 static octave_value_list
-octregexp (const octave_value_list& args, int nargout,
-           const std::string& who, bool case_insensitive = false)
+regexp_results (const regexp::match_data& rx_lst, const std::string& buffer,
+                const regexp::opts& options, bool extra_options,
+                const octave_value_list& args, int nargout)
 {
   octave_value_list retval;
 
   int nargin = args.length ();
 
-  // Make sure we have string, pattern
-  const std::string buffer = args(0).string_value ();
-
-  std::string pattern = args(1).string_value ();
-
-  // Rewrite pattern for PCRE
-  pattern = do_regexp_ptn_string_escapes (pattern, args(1).is_sq_string ());
-
-  regexp::opts options;
-  options.case_insensitive (case_insensitive);
-  bool extra_options = false;
-  parse_options (options, args, who, 2, extra_options);
-
-  const regexp::match_data rx_lst
-    = regexp::match (pattern, buffer, options, who);
-
   string_vector named_pats = rx_lst.named_patterns ();
 
   std::size_t sz = rx_lst.size ();
@@ -541,6 +530,81 @@ octregexp (const octave_value_list& args, int nargout,
   return retval;
 }
 
+static octave_value_list
+octregexp (const octave_value_list& args, int nargout,
+           const std::string& who, bool case_insensitive = false)
+{
+  // Make sure we have string, pattern
+  const std::string buffer = args(0).string_value ();
+
+  std::string pattern = args(1).string_value ();
+
+  // Rewrite pattern for PCRE
+  pattern = do_regexp_ptn_string_escapes (pattern, args(1).is_sq_string ());
+
+  regexp::opts options;
+  options.case_insensitive (case_insensitive);
+  bool extra_options = false;
+  parse_options (options, args, who, 2, extra_options);
+
+  const regexp::match_data rx_lst
+    = regexp::match (pattern, buffer, options, who);
+
+  return regexp_results (rx_lst, buffer, options, extra_options,
+                         args, nargout);
+}
+
+// Match the single pattern PAT against each string of CELLSTR.  The
+// options are parsed and the pattern is compiled only once for all
+// elements, and the results are stored directly in the output cells.
+
+static octave_value_list
+octcellregexp_pattern (const Cell& cellstr, const octave_value& pat,
+                       const octave_value_list& args, int nargout,
+                       const std::string& who, bool case_insensitive)
+{
+  octave_value_list retval;
+
+  OCTAVE_LOCAL_BUFFER (Cell, newretval, nargout);
+
+  for (int j = 0; j < nargout; j++)
+    newretval[j].resize (cellstr.dims ());
+
+  octave_idx_type n = cellstr.numel ();
+
+  if (n > 0)
+    {
+      std::string pattern = pat.string_value ();
+
+      // Rewrite pattern for PCRE
+      pattern = do_regexp_ptn_string_escapes (pattern, pat.is_sq_string ());
+
+      regexp::opts options;
+      options.case_insensitive (case_insensitive);
+      bool extra_options = false;
+      parse_options (options, args, who, 2, extra_options);
+
+      const regexp rx (pattern, options, who);
+
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          const std::string buffer = cellstr(i).string_value ();
+
+          octave_value_list tmp
+            = regexp_results (rx.match (buffer), buffer, options,
+                              extra_options, args, nargout);
+
+          for (int j = 0; j < nargout; j++)
+            newretval[j](i) = tmp(j);
+        }
+    }
+
+  for (int j = 0; j < nargout; j++)
+    retval(j) = octave_value (newretval[j]);
+
+  return retval;
+}
+
 static octave_value_list
 octcellregexp (const octave_value_list& args, int nargout,
                const std::string& who, bool case_insensitive = false)
@@ -557,22 +621,8 @@ octcellregexp (const octave_value_list& args, int nargout,
           Cell cellpat = args(1).cell_value ();
 
           if (cellpat.numel () == 1)
-            {
-              for (int j = 0; j < nargout; j++)
-                newretval[j].resize (cellstr.dims ());
-
-              new_args(1) = cellpat(0);
-
-              for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-                {
-                  new_args(0) = cellstr(i);
-                  octave_value_list tmp = octregexp (new_args, nargout, who,
-                                                     case_insensitive);
-
-                  for (int j = 0; j < nargout; j++)
-                    newretval[j](i) = tmp(j);
-                }
-            }
+            return octcellregexp_pattern (cellstr, cellpat(0), args, nargout,
+                                          who, case_insensitive);
           else if (cellstr.numel () == 1)
             {
               for (int j = 0; j < nargout; j++)
@@ -614,20 +664,8 @@ octcellregexp (const octave_value_list& args, int nargout,
             error ("regexp: cell array arguments must be scalar or equal size");
         }
       else
-        {
-          for (int j = 0; j < nargout; j++)
-            newretval[j].resize (cellstr.dims ());
-
-          for (octave_idx_type i = 0; i < cellstr.numel (); i++)
-            {
-              new_args(0) = cellstr(i);
-              octave_value_list tmp = octregexp (new_args, nargout, who,
-                                                 case_insensitive);
-
-              for (int j = 0; j < nargout; j++)
-                newretval[j](i) = tmp(j);
-            }
-        }
+        return octcellregexp_pattern (cellstr, args(1), args, nargout,
+                                      who, case_insensitive);
 
       for (int j = 0; j < nargout; j++)
         retval(j) = octave_value (newretval[j]);
@@ -1142,6 +1180,25 @@ comprehensive list of @code{regexp} operator syntax see the
 %!        {6;[3,7];[1,9]})
 %!assert (regexp ('Strings', {'t','s'}), {2, 7})
 
+## Test cellstr input with a single pattern and output options
+%!test
+%! str = {'ab12', 'cd', '3e4'; 'f5', '', 'g'};
+%! [tok, s] = regexp (str, '([a-z])(\d)', 'tokens', 'start');
+%! assert (size (tok), [2, 3]);
+%! assert (tok{1,1}, {{'b', '1'}});
+%! assert (tok{1,2}, cell (1, 0));
+%! assert (tok{1,3}, {{'e', '4'}});
+%! assert (tok{2,1}, {{'f', '5'}});
+%! assert (s, {2, zeros(1,0), 2; 1, zeros(1,0), zeros(1,0)});
+%! [m, sp] = regexp (str, '\d', 'match', 'split', 'once');
+%! assert (m, {'1', '', '3'; '5', '', ''});
+%! assert (sp, {{'ab', '2'}, 'cd', {'', 'e4'}; {'f', ''}, '', 'g'});
+%! assert (regexpi ({'ABC', 'abc'}, {'b'}), {2, 2});
+%! [s, e] = regexp (cell (0, 3), '(');
+%! assert (s, cell (0, 3));
+%! assert (e, cell (0, 3));
+%!error <unrecognized option> regexp ({'abc'}, 'b', 'BadArg')
+
 ## Test case for lookaround operators
 %!test
 %! assert (regexp ('Iraq', 'q(?!u)'), 4);
@@ -1214,6 +1271,26 @@ comprehensive list of @code{regexp} operator syntax see the
 %!assert <*62705> (regexpi ('<n>', '\(?<n\>\)?'), 1)
 %!assert <62705> (regexpi ('<n>a', '\(?<n\>a\)?'), 1)
 
+## Test that compiled patterns are reused only with the same options
+%!test
+%! for i = 1:3
+%!   assert (regexp ('aBc', 'b'), zeros (1, 0));
+%!   assert (regexp ('aBc', 'b', 'ignorecase'), 2);
+%!   assert (regexp ("a\nb", 'a.b'), 1);
+%!   assert (regexp ("a\nb", 'a.b', 'dotexceptnewline'), zeros (1, 0));
+%!   [tok, nm] = regexp ('ab12', '(?<letters>[a-z]+)(?<digits>\d+)',
+%!                       'tokens', 'names');
+%!   assert (tok, {{'ab', '12'}});
+%!   assert (nm, struct ('letters', 'ab', 'digits', '12'));
+%! endfor
+
+## Test that many different patterns do not interfere with each other
+%!test
+%! for i = 1:100
+%!   assert (regexp (sprintf ('x%dy', i), sprintf ('%d', i)), 2);
+%! endfor
+%! assert (regexp ('x1y', '1'), 2);
+
 ## Test input validation
 %!error regexp ('string', 'tri', 'BadArg')
 %!error regexp ('string')
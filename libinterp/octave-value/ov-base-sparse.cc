@@ -77,6 +77,8 @@ octave_base_sparse<T>::do_index_op (const octave_value_list& idx,
           {
             octave::idx_vector i = idx (0).index_vector ();
 
+            invalidate_row_cache ();
+
             retval = octave_value (matrix.index (i, resize_ok));
           }
           break;
@@ -88,7 +90,27 @@ octave_base_sparse<T>::do_index_op (const octave_value_list& idx,
             k = 1;
             octave::idx_vector j = idx (1).index_vector ();
 
-            retval = octave_value (matrix.index (i, j, resize_ok));
+            octave_idx_type nr = matrix.rows ();
+            octave_idx_type nc = matrix.cols ();
+
+            bool row_slice = (j.is_colon () && ! i.is_colon () && nc > 1
+                              && i.extent (nr) <= nr);
+
+            if (row_slice && use_row_cache ())
+              {
+                // A(I,:) is A.'(:,I).', and copying whole columns of
+                // the transpose is cheap.
+                T tmp = trans_matrix.index (j, i, false);
+
+                retval = octave_value (tmp.transpose ());
+              }
+            else
+              {
+                if (! row_slice)
+                  invalidate_row_cache ();
+
+                retval = octave_value (matrix.index (i, j, resize_ok));
+              }
           }
           break;
 
@@ -106,6 +128,57 @@ octave_base_sparse<T>::do_index_op (const octave_value_list& idx,
   return retval;
 }
 
+/*
+## Repeated row slicing uses a cached transpose
+%!test
+%! A = sprand (30, 20, 0.2) + 1i * sprand (30, 20, 0.2);
+%! F = full (A);
+%! for i = [3, 30, 1, 7, 12, 3, 30, 1, 7, 12]
+%!   assert (A(i,:), sparse (F(i,:)));
+%! endfor
+%! assert (A([2, 2, 9, 5],:), sparse (F([2, 2, 9, 5],:)));
+%! assert (A(logical (mod (1:30, 2)),:), sparse (F(logical (mod (1:30, 2)),:)));
+%! B = A;
+%! A(4,:) = 1:20;
+%! F(4,:) = 1:20;
+%! assert (A(4,:), sparse (1:20));
+%! assert (A(3:5,:), sparse (F(3:5,:)));
+%! assert (B(4,:), sparse (full (B)(4,:)));
+%! A(5,:) = [];
+%! F(5,:) = [];
+%! assert (A(5,:), sparse (F(5,:)));
+%! ## Other indexing between row slices discards the cached transpose
+%! for i = 1:10
+%!   assert (A(i,:), sparse (F(i,:)));
+%!   assert (A(:,2), sparse (F(:,2)));
+%! endfor
+%!test
+%! A = sparse (logical (eye (4)));
+%! assert (A(2,:), sparse (logical ([0, 1, 0, 0])));
+%! assert (A([4, 1],:), sparse (logical ([0, 0, 0, 1; 1, 0, 0, 0])));
+%!error <out of bound 4>
+%! A = sparse (eye (4));
+%! A(1,:);
+%! A(2,:);
+%! A(5,:);
+*/
+
+template <typename T>
+bool
+octave_base_sparse<T>::use_row_cache () const
+{
+  if (row_index_count < row_cache_threshold)
+    {
+      if (matrix.nnz () > row_cache_max_nnz
+          || ++row_index_count < row_cache_threshold)
+        return false;
+
+      trans_matrix = matrix.transpose ();
+    }
+
+  return true;
+}
+
 template <typename T>
 octave_value
 octave_base_sparse<T>::subsref (const std::string& type,
@@ -229,6 +302,7 @@ octave_base_sparse<MT>::delete_elements (const octave_value_list& idx)
 
   // Invalidate the matrix type
   typ.invalidate_type ();
+  invalidate_row_cache ();
 }
 
 template <typename T>
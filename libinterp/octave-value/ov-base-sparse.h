@@ -51,25 +51,30 @@ class OCTINTERP_API octave_base_sparse : public octave_base_value
 public:
 
   octave_base_sparse ()
-    : octave_base_value (), matrix (), typ (MatrixType ())
+    : octave_base_value (), matrix (), typ (MatrixType ()),
+      trans_matrix (), row_index_count (0)
   { }
 
   octave_base_sparse (const T& a)
-    : octave_base_value (), matrix (a), typ (MatrixType ())
+    : octave_base_value (), matrix (a), typ (MatrixType ()),
+      trans_matrix (), row_index_count (0)
   {
     if (matrix.ndims () == 0)
       matrix.resize (dim_vector (0, 0));
   }
 
   octave_base_sparse (const T& a, const MatrixType& t)
-    : octave_base_value (), matrix (a), typ (t)
+    : octave_base_value (), matrix (a), typ (t),
+      trans_matrix (), row_index_count (0)
   {
     if (matrix.ndims () == 0)
       matrix.resize (dim_vector (0, 0));
   }
 
   octave_base_sparse (const octave_base_sparse& a)
-    : octave_base_value (), matrix (a.matrix), typ (a.typ) { }
+    : octave_base_value (), matrix (a.matrix), typ (a.typ),
+      trans_matrix (), row_index_count (0)
+  { }
 
   ~octave_base_sparse () = default;
 
@@ -157,6 +162,7 @@ public:
 
     // Invalidate matrix type.
     typ.invalidate_type ();
+    invalidate_row_cache ();
   }
 
   OCTINTERP_API void delete_elements (const octave_value_list& idx);
@@ -245,9 +251,30 @@ protected:
   OCTINTERP_API octave_value
   map (octave_base_value::unary_mapper_t umap) const;
 
+  OCTINTERP_API bool use_row_cache () const;
+
+  void invalidate_row_cache () const
+  {
+    trans_matrix = T ();
+    row_index_count = 0;
+  }
+
   T matrix;
 
   mutable MatrixType typ;
+
+  // Row slices A(I,:) are costly for compressed column storage.  After
+  // a run of row slices with no other indexing in between, the transpose
+  // of the matrix is kept so that rows can be extracted as columns.  It is
+  // discarded by any other indexing and whenever the matrix is modified.
+  // Matrices with more than row_cache_max_nnz elements are never copied.
+  static const int row_cache_threshold = 8;
+
+  static const octave_idx_type row_cache_max_nnz = 16777216;
+
+  mutable T trans_matrix;
+
+  mutable int row_index_count;
 };
 
 #endif
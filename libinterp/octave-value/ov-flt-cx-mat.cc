@@ -247,7 +247,7 @@ octave_float_complex_matrix::sparse_matrix_value (bool force_conversion) const
 SparseComplexMatrix
 octave_float_complex_matrix::sparse_complex_matrix_value (bool) const
 {
-  return SparseComplexMatrix (complex_matrix_value ());
+  return SparseComplexMatrix (float_complex_matrix_value ());
 }
 
 octave_value
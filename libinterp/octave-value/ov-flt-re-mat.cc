@@ -223,7 +223,7 @@ octave_float_matrix::char_array_value (bool) const
 SparseMatrix
 octave_float_matrix::sparse_matrix_value (bool) const
 {
-  return SparseMatrix (matrix_value ());
+  return SparseMatrix (float_matrix_value ());
 }
 
 SparseComplexMatrix
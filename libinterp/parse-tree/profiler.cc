@@ -27,9 +27,14 @@
 #  include "config.h"
 #endif
 
+#include <chrono>
+#include <new>
+
+#include "call-stack.h"
 #include "defun.h"
 #include "event-manager.h"
 #include "interpreter.h"
+#include "oct-alloc-stats.h"
 #include "oct-time.h"
 #include "ov-struct.h"
 #include "pager.h"
@@ -38,7 +43,8 @@
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 profiler::stats::stats ()
-  : m_time (0.0), m_calls (0), m_recursive (false),
+  : m_time (0.0), m_calls (0), m_bytes_allocated (0), m_bytes_freed (0),
+    m_allocations (0), m_peak_bytes (0), m_recursive (false),
     m_parents (), m_children ()
 { }
 
@@ -56,7 +62,9 @@ profiler::stats::function_set_value (const function_set& list)
 }
 
 profiler::tree_node::tree_node (tree_node *p, octave_idx_type f)
-  : m_parent (p), m_fcn_id (f), m_children (), m_time (0.0), m_calls (0)
+  : m_parent (p), m_fcn_id (f), m_children (), m_time (0.0), m_calls (0),
+    m_bytes_allocated (0), m_bytes_freed (0), m_allocations (0),
+    m_peak_bytes (0), m_entry_live (0), m_running_peak (0)
 { }
 
 profiler::tree_node::~tree_node ()
@@ -101,6 +109,11 @@ profiler::tree_node::build_flat (flat_profile& data) const
       entry.m_time += m_time;
       entry.m_calls += m_calls;
 
+      entry.m_bytes_allocated += m_bytes_allocated;
+      entry.m_bytes_freed += m_bytes_freed;
+      entry.m_allocations += m_allocations;
+      entry.m_peak_bytes = std::max (entry.m_peak_bytes, m_peak_bytes);
+
       if (! m_parent)
         error ("unexpected: m_parent is nullptr in profiler::tree_node::build_flat - please report this bug");
 
@@ -170,13 +183,22 @@ profiler::tree_node::get_hierarchical (double *total) const
 }
 
 profiler::profiler ()
-  : m_known_functions (), m_fcn_index (),
-    m_enabled (false), m_call_tree (new tree_node (nullptr, 0)),
-    m_active_fcn (nullptr), m_last_time (-1.0)
+  : m_known_functions (), m_fcn_index (), m_line_stats (),
+    m_enabled (false), m_lines (false), m_memory (false),
+    m_call_tree (new tree_node (nullptr, 0)),
+    m_active_fcn (nullptr), m_samples (), m_pending_samples (0),
+    m_sampler (), m_sampler_mutex (), m_sampler_cv (),
+    m_stop_sampler (false), m_last_time (-1.0), m_last_bytes_allocated (0),
+    m_last_bytes_freed (0), m_last_allocations (0)
 { }
 
 profiler::~profiler ()
 {
+  stop_sampling ();
+
+  if (m_memory)
+    alloc_stats::enable (false);
+
   delete m_call_tree;
 }
 
@@ -184,6 +206,16 @@ void
 profiler::set_active (bool value)
 {
   m_enabled = value;
+
+  alloc_stats::enable (m_enabled && m_memory);
+}
+
+void
+profiler::set_memory (bool value)
+{
+  m_memory = value;
+
+  alloc_stats::enable (m_enabled && m_memory);
 }
 
 void
@@ -199,7 +231,12 @@ profiler::enter_function (const std::string& fcn)
   // If there is already an active function, add to its time before
   // pushing the new one.
   if (m_active_fcn && m_active_fcn != m_call_tree)
-    add_current_time ();
+    {
+      add_current_time ();
+
+      if (m_memory)
+        add_current_memory ();
+    }
 
   // Map the function's name to its index.
   octave_idx_type fcn_idx;
@@ -216,7 +253,24 @@ profiler::enter_function (const std::string& fcn)
   if (! m_active_fcn)
     m_active_fcn = m_call_tree;
 
-  m_active_fcn = m_active_fcn->enter (fcn_idx);
+  if (m_memory)
+    {
+      // The peak of the caller so far is saved before it is reset to
+      // measure the peak of the callee.
+      m_active_fcn->update_peak (alloc_stats::peak_bytes ());
+
+      m_active_fcn = m_active_fcn->enter (fcn_idx);
+
+      std::ptrdiff_t live = alloc_stats::live_bytes ();
+      m_active_fcn->start_peak (live);
+      alloc_stats::set_peak (live);
+
+      m_last_bytes_allocated = alloc_stats::bytes_allocated ();
+      m_last_bytes_freed = alloc_stats::bytes_freed ();
+      m_last_allocations = alloc_stats::allocations ();
+    }
+  else
+    m_active_fcn = m_active_fcn->enter (fcn_idx);
 
   m_last_time = query_time ();
 
@@ -238,7 +292,24 @@ profiler::exit_function (const std::string& fcn)
 
       fcn_index_map::iterator pos = m_fcn_index.find (fcn);
 
-      m_active_fcn = m_active_fcn->exit (pos->second);
+      if (enabled () && m_memory)
+        {
+          add_current_memory ();
+
+          // The peak of the callee is also part of the caller's peak.
+          m_active_fcn->finish_peak (alloc_stats::peak_bytes ());
+          std::ptrdiff_t peak = m_active_fcn->running_peak ();
+
+          m_active_fcn = m_active_fcn->exit (pos->second);
+
+          if (m_active_fcn)
+            {
+              m_active_fcn->update_peak (peak);
+              alloc_stats::set_peak (m_active_fcn->running_peak ());
+            }
+        }
+      else
+        m_active_fcn = m_active_fcn->exit (pos->second);
 
       // If this was an "inner call", we resume executing the parent function
       // up the stack.  So note the start-time for this!
@@ -249,11 +320,13 @@ profiler::exit_function (const std::string& fcn)
 void
 profiler::reset ()
 {
-  if (enabled ())
+  if (enabled () || sampling ())
     error ("profile: can't reset active profiler");
 
   m_known_functions.clear ();
   m_fcn_index.clear ();
+  m_line_stats.clear ();
+  m_samples.clear ();
 
   if (m_call_tree)
     {
@@ -265,6 +338,39 @@ profiler::reset ()
   m_last_time = -1.0;
 }
 
+void
+profiler::add_line_time (octave_idx_type fcn_id, int line, double dt)
+{
+  if (static_cast<std::size_t> (fcn_id) > m_line_stats.size ())
+    m_line_stats.resize (fcn_id);
+
+  line_stats& entry = m_line_stats[fcn_id - 1][line];
+
+  entry.m_calls++;
+  entry.m_time += dt;
+}
+
+octave_value
+profiler::executed_lines (octave_idx_type fcn_id) const
+{
+  if (static_cast<std::size_t> (fcn_id) > m_line_stats.size ())
+    return Matrix (0, 3);
+
+  const line_map& lines = m_line_stats[fcn_id - 1];
+
+  Matrix retval (lines.size (), 3);
+  octave_idx_type i = 0;
+  for (const auto& line_entry : lines)
+    {
+      retval(i, 0) = line_entry.first;
+      retval(i, 1) = line_entry.second.m_calls;
+      retval(i, 2) = line_entry.second.m_time;
+      i++;
+    }
+
+  return retval;
+}
+
 octave_value
 profiler::get_flat () const
 {
@@ -284,6 +390,11 @@ profiler::get_flat () const
       Cell rv_recursive (n, 1);
       Cell rv_parents (n, 1);
       Cell rv_children (n, 1);
+      Cell rv_lines (n, 1);
+      Cell rv_allocated (n, 1);
+      Cell rv_freed (n, 1);
+      Cell rv_peak (n, 1);
+      Cell rv_allocations (n, 1);
 
       for (octave_idx_type i = 0; i != n; ++i)
         {
@@ -293,6 +404,11 @@ profiler::get_flat () const
           rv_recursive(i) = octave_value (flat[i].m_recursive);
           rv_parents(i) = stats::function_set_value (flat[i].m_parents);
           rv_children(i) = stats::function_set_value (flat[i].m_children);
+          rv_lines(i) = executed_lines (i + 1);
+          rv_allocated(i) = octave_value (flat[i].m_bytes_allocated);
+          rv_freed(i) = octave_value (flat[i].m_bytes_freed);
+          rv_peak(i) = octave_value (flat[i].m_peak_bytes);
+          rv_allocations(i) = octave_value (flat[i].m_allocations);
         }
 
       octave_map m;
@@ -303,6 +419,11 @@ profiler::get_flat () const
       m.assign ("IsRecursive", rv_recursive);
       m.assign ("Parents", rv_parents);
       m.assign ("Children", rv_children);
+      m.assign ("ExecutedLines", rv_lines);
+      m.assign ("TotalMemAllocated", rv_allocated);
+      m.assign ("TotalMemFreed", rv_freed);
+      m.assign ("PeakMem", rv_peak);
+      m.assign ("NumAllocations", rv_allocations);
 
       retval = m;
     }
@@ -316,6 +437,11 @@ profiler::get_flat () const
         "IsRecursive",
         "Parents",
         "Children",
+        "ExecutedLines",
+        "TotalMemAllocated",
+        "TotalMemFreed",
+        "PeakMem",
+        "NumAllocations",
         nullptr
       };
 
@@ -353,6 +479,70 @@ profiler::get_hierarchical () const
   return retval;
 }
 
+void
+profiler::start_sampling (double interval)
+{
+  stop_sampling ();
+
+  m_stop_sampler = false;
+
+  std::chrono::duration<double> dt (interval);
+
+  m_sampler = std::thread ([this, dt] ()
+    {
+      std::unique_lock<std::mutex> lock (m_sampler_mutex);
+
+      while (! m_sampler_cv.wait_for (lock, dt,
+                                      [this] () { return m_stop_sampler; }))
+        m_pending_samples.fetch_add (1, std::memory_order_relaxed);
+    });
+}
+
+void
+profiler::stop_sampling ()
+{
+  if (! m_sampler.joinable ())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock (m_sampler_mutex);
+    m_stop_sampler = true;
+  }
+
+  m_sampler_cv.notify_one ();
+  m_sampler.join ();
+
+  m_pending_samples = 0;
+}
+
+void
+profiler::take_sample (const call_stack& cs)
+{
+  int n = m_pending_samples.exchange (0, std::memory_order_relaxed);
+
+  // This may be called while the stack is unwound, so never throw.
+  try
+    {
+      if (n > 0)
+        m_samples[cs.folded_stack ()] += n;
+    }
+  catch (const std::bad_alloc&)
+    { }
+}
+
+octave_value
+profiler::get_folded () const
+{
+  Cell retval (m_samples.size (), 1);
+
+  octave_idx_type i = 0;
+  for (const auto& stack_count : m_samples)
+    retval(i++) = stack_count.first + ' '
+                  + std::to_string (stack_count.second);
+
+  return retval;
+}
+
 double
 profiler::query_time () const
 {
@@ -372,21 +562,46 @@ profiler::add_current_time ()
     }
 }
 
+void
+profiler::add_current_memory ()
+{
+  std::size_t allocated = alloc_stats::bytes_allocated ();
+  std::size_t freed = alloc_stats::bytes_freed ();
+  std::size_t allocations = alloc_stats::allocations ();
+
+  if (m_active_fcn)
+    m_active_fcn->add_memory (allocated - m_last_bytes_allocated,
+                              freed - m_last_bytes_freed,
+                              allocations - m_last_allocations);
+
+  m_last_bytes_allocated = allocated;
+  m_last_bytes_freed = freed;
+  m_last_allocations = allocations;
+}
+
 // Enable or disable the profiler data collection.
 DEFMETHOD (__profiler_enable__, interp, args, ,
            doc: /* -*- texinfo -*-
-@deftypefn {} {@var{state} =} __profiler_enable__ ()
+@deftypefn  {} {[@var{state}, @var{lines}, @var{memory}] =} __profiler_enable__ ()
+@deftypefnx {} {@var{state} =} __profiler_enable__ (@var{state}, @var{lines})
+@deftypefnx {} {@var{state} =} __profiler_enable__ (@var{state}, @var{lines}, @var{memory})
 Undocumented internal function.
 @end deftypefn */)
 {
   int nargin = args.length ();
 
-  if (nargin > 1)
+  if (nargin > 3)
     print_usage ();
 
   profiler& profiler = interp.get_profiler ();
 
-  if (nargin == 1)
+  if (nargin >= 2)
+    profiler.set_lines (args(1).bool_value ());
+
+  if (nargin == 3)
+    profiler.set_memory (args(2).bool_value ());
+
+  if (nargin >= 1)
     {
       profiler.set_active (args(0).bool_value ());
 
@@ -398,7 +613,40 @@ Undocumented internal function.
       evmgr.gui_status_update ("profiler", status);  // tell GUI
     }
 
-  return ovl (profiler.enabled ());
+  return ovl (profiler.enabled (), profiler.lines (), profiler.memory ());
+}
+
+// Start or stop the sampling profiler.
+DEFMETHOD (__profiler_sample__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{state} =} __profiler_sample__ ()
+@deftypefnx {} {@var{state} =} __profiler_sample__ (@var{interval})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  profiler& profiler = interp.get_profiler ();
+
+  if (nargin == 1)
+    {
+      double interval = args(0).double_value ();
+
+      if (interval > 0)
+        profiler.start_sampling (interval);
+      else
+        profiler.stop_sampling ();
+
+      event_manager& evmgr = interp.get_event_manager ();
+      evmgr.gui_status_update ("profiler",
+                               (profiler.enabled () || profiler.sampling ()
+                                ? "on" : "off"));
+    }
+
+  return ovl (profiler.sampling ());
 }
 
 // Clear all collected profiling data.
@@ -436,4 +684,19 @@ Undocumented internal function.
     return ovl (profiler.get_flat ());
 }
 
+// Query the call stacks collected by the sampling profiler.
+DEFMETHOD (__profiler_folded__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn {} {@var{stacks} =} __profiler_folded__ ()
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  profiler& profiler = interp.get_profiler ();
+
+  return ovl (profiler.get_folded ());
+}
+
 OCTAVE_END_NAMESPACE(octave)
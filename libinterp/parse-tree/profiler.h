@@ -28,16 +28,23 @@
 
 #include "octave-config.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 class octave_value;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class call_stack;
+
 class OCTINTERP_API profiler
 {
 public:
@@ -83,6 +90,44 @@ public:
     }
   };
 
+  // Time a statement on line LINE of the currently active function and
+  // count its execution, if line-level profiling is enabled.  Like enter,
+  // this is protected from stack unwinding.
+  class line_timer
+  {
+  private:
+
+    profiler& m_profiler;
+    octave_idx_type m_fcn_id;
+    int m_line;
+    double m_start;
+
+  public:
+
+    line_timer (profiler& p, int line)
+      : m_profiler (p), m_fcn_id (0), m_line (line), m_start (0.0)
+    {
+      if (m_profiler.lines_enabled () && m_line > 0)
+        {
+          m_fcn_id = m_profiler.active_function ();
+
+          // Statements outside of any function are not recorded.
+          if (m_fcn_id != 0)
+            m_start = m_profiler.query_time ();
+        }
+    }
+
+    OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (line_timer)
+
+    ~line_timer ()
+    {
+      // The profiler may have been stopped and cleared by this statement.
+      if (m_fcn_id != 0 && m_profiler.lines_enabled ())
+        m_profiler.add_line_time (m_fcn_id, m_line,
+                                  m_profiler.query_time () - m_start);
+    }
+  };
+
   profiler ();
 
   OCTAVE_DISABLE_COPY_MOVE (profiler)
@@ -92,11 +137,37 @@ public:
   bool enabled () const { return m_enabled; }
   void set_active (bool);
 
+  bool lines_enabled () const { return m_enabled && m_lines; }
+  bool lines () const { return m_lines; }
+  void set_lines (bool value) { m_lines = value; }
+
+  // Whether the memory allocated for arrays is attributed to functions.
+  bool memory () const { return m_memory; }
+  void set_memory (bool value);
+
   void reset ();
 
   octave_value get_flat () const;
   octave_value get_hierarchical () const;
 
+  // Sampling profiler.  A background thread requests a sample every
+  // INTERVAL seconds.  The interpreter takes requested samples before the
+  // next statement or when a function returns, so the sampling thread
+  // never accesses the interpreter.  Samples are counted per call stack.
+
+  void start_sampling (double interval);
+  void stop_sampling ();
+
+  bool sampling () const { return m_sampler.joinable (); }
+
+  bool sample_pending () const
+  { return m_pending_samples.load (std::memory_order_relaxed) != 0; }
+
+  void take_sample (const call_stack& cs);
+
+  // Cell array with one line "fcn1;fcn2;... count" for each sampled stack.
+  octave_value get_folded () const;
+
 private:
 
   // One entry in the flat profile (i.e., a collection of data for a single
@@ -120,6 +191,11 @@ private:
     double m_time;
     std::size_t m_calls;
 
+    std::size_t m_bytes_allocated;
+    std::size_t m_bytes_freed;
+    std::size_t m_allocations;
+    std::ptrdiff_t m_peak_bytes;
+
     bool m_recursive;
 
     function_set m_parents;
@@ -142,6 +218,35 @@ private:
 
     void add_time (double dt) { m_time += dt; }
 
+    void add_memory (std::size_t allocated, std::size_t freed,
+                     std::size_t allocations)
+    {
+      m_bytes_allocated += allocated;
+      m_bytes_freed += freed;
+      m_allocations += allocations;
+    }
+
+    // Track the peak of live array memory while this node is active.
+    // LIVE and PEAK are the values from octave::alloc_stats.
+    void start_peak (std::ptrdiff_t live)
+    {
+      m_entry_live = live;
+      m_running_peak = live;
+    }
+
+    void update_peak (std::ptrdiff_t peak)
+    {
+      m_running_peak = std::max (m_running_peak, peak);
+    }
+
+    std::ptrdiff_t running_peak () const { return m_running_peak; }
+
+    void finish_peak (std::ptrdiff_t peak)
+    {
+      update_peak (peak);
+      m_peak_bytes = std::max (m_peak_bytes, m_running_peak - m_entry_live);
+    }
+
     // Enter a child function.  It is created in the list of children if it
     // wasn't already there.  The now-active child node is returned.
     tree_node * enter (octave_idx_type);
@@ -151,6 +256,8 @@ private:
     // then-active node, which is our parent.
     tree_node * exit (octave_idx_type);
 
+    octave_idx_type fcn_id () const { return m_fcn_id; }
+
     void build_flat (flat_profile&) const;
 
     // Get the hierarchical profile for this node and its children.  If total
@@ -170,6 +277,17 @@ private:
     double m_time;
 
     std::size_t m_calls;
+
+    // Array memory allocated and freed *directly* on this level.
+    std::size_t m_bytes_allocated;
+    std::size_t m_bytes_freed;
+    std::size_t m_allocations;
+
+    // Largest increase of live array memory during a call, including
+    // children, and the state of the call that is currently active.
+    std::ptrdiff_t m_peak_bytes;
+    std::ptrdiff_t m_entry_live;
+    std::ptrdiff_t m_running_peak;
   };
 
   // Each function we see in the profiler is given a unique index (which
@@ -183,20 +301,62 @@ private:
   function_set m_known_functions;
   fcn_index_map m_fcn_index;
 
+  // Number of executions and total time of the statements on each line,
+  // for each function.  Indexed like m_known_functions.
+  struct line_stats
+  {
+    std::size_t m_calls = 0;
+    double m_time = 0.0;
+  };
+
+  typedef std::map<int, line_stats> line_map;
+
+  std::vector<line_map> m_line_stats;
+
   bool m_enabled;
 
+  // Whether statements are timed by line.
+  bool m_lines;
+
+  // Whether array allocations are recorded.
+  bool m_memory;
+
   tree_node *m_call_tree;
   tree_node *m_active_fcn;
 
+  // Number of samples for each folded call stack.
+  std::map<std::string, std::size_t> m_samples;
+
+  std::atomic<int> m_pending_samples;
+
+  std::thread m_sampler;
+  std::mutex m_sampler_mutex;
+  std::condition_variable m_sampler_cv;
+  bool m_stop_sampler;
+
   // Store last timestamp we had, when the currently active function was
   // called.
   double m_last_time;
 
+  // Likewise for the allocation counters.
+  std::size_t m_last_bytes_allocated;
+  std::size_t m_last_bytes_freed;
+  std::size_t m_last_allocations;
+
   // These are private as only the unwind-protecting inner class enter
   // should be allowed to call them.
   void enter_function (const std::string&);
   void exit_function (const std::string&);
 
+  // Index of the currently active function, or 0 if there is none.
+  octave_idx_type active_function () const
+  { return m_active_fcn ? m_active_fcn->fcn_id () : 0; }
+
+  void add_line_time (octave_idx_type fcn_id, int line, double dt);
+
+  // Matrix with rows [line, calls, time] for the function with index FCN_ID.
+  octave_value executed_lines (octave_idx_type fcn_id) const;
+
   // Query a timestamp, used for timing calls (obviously).
   // This is not static because in the future, maybe we want a flag
   // in the profiler or something to choose between cputime, wall-time,
@@ -207,6 +367,10 @@ private:
   // This is called from two different positions, thus it is useful to have
   // it as a separate function.
   void add_current_time ();
+
+  // Add the array memory allocated since the last call or since the
+  // currently active function was called to that function.
+  void add_current_memory ();
 };
 
 OCTAVE_END_NAMESPACE(octave)
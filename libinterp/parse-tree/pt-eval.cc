@@ -2522,12 +2522,19 @@ tree_evaluator::push_stack_frame (octave_function *fcn)
 void
 tree_evaluator::pop_stack_frame ()
 {
+  // Attribute samples taken while the function was running to it.
+  if (m_profiler.sample_pending ())
+    m_profiler.take_sample (m_call_stack);
+
   m_call_stack.pop ();
 }
 
 std::shared_ptr<stack_frame>
 tree_evaluator::pop_return_stack_frame ()
 {
+  if (m_profiler.sample_pending ())
+    m_profiler.take_sample (m_call_stack);
+
   return m_call_stack.pop_return ();
 }
 
@@ -4002,6 +4009,9 @@ tree_evaluator::visit_statement (tree_statement& stmt)
              && m_call_stack.current_frame () == m_debug_frame))
         m_call_stack.set_location (stmt.line (), stmt.column ());
 
+      if (m_profiler.sample_pending ())
+        m_profiler.take_sample (m_call_stack);
+
       try
         {
           if (cmd)
@@ -4034,6 +4044,8 @@ tree_evaluator::visit_statement (tree_statement& stmt)
               // evaluate the expression and that should take care of
               // everything, binding ans as necessary?
 
+              profiler::line_timer timer (m_profiler, stmt.line ());
+
               octave_value tmp_result = expr->evaluate (*this, 0);
 
               if (tmp_result.is_defined ())
@@ -40,6 +40,7 @@
 #include "lo-error.h"
 #include "lo-traits.h"
 #include "lo-utils.h"
+#include "oct-alloc-stats.h"
 #include "oct-refcount.h"
 #include "oct-sort.h"
 #include "quit.h"
@@ -176,7 +177,10 @@ protected:
     explicit ArrayRep (pointer ptr, const dim_vector& dv,
                        const Alloc& xallocator = Alloc ())
       : Alloc (xallocator), m_data (ptr), m_len (dv.safe_numel ()), m_count (1)
-    { }
+    {
+      // Balance the accounting in deallocate for the adopted storage.
+      octave::alloc_stats::allocated (m_len * sizeof (T));
+    }
 
     // FIXME: Should the allocator be copied or created with the default?
     ArrayRep (const ArrayRep& a)
@@ -202,6 +206,7 @@ protected:
       pointer data = Alloc_traits::allocate (*this, len);
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::construct (*this, data+i);
+      octave::alloc_stats::allocated (len * sizeof (T));
       return data;
     }
 
@@ -210,6 +215,7 @@ protected:
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::destroy (*this, data+i);
       Alloc_traits::deallocate (*this, data, len);
+      octave::alloc_stats::freed (len * sizeof (T));
     }
   };
 
@@ -50,6 +50,7 @@
 
 #include "dDiagMatrix.h"
 #include "CDiagMatrix.h"
+#include "fCMatrix.h"
 #include "CSparse.h"
 #include "boolSparse.h"
 #include "dSparse.h"
@@ -88,6 +89,32 @@ SparseComplexMatrix::SparseComplexMatrix (const SparseBoolMatrix& a)
     }
 }
 
+// Convert single precision data directly, without a full double copy.
+
+SparseComplexMatrix::SparseComplexMatrix (const FloatComplexMatrix& a)
+  : MSparse<Complex> (a.rows (), a.cols (), a.nnz ())
+{
+  octave_idx_type nr = rows ();
+  octave_idx_type nc = cols ();
+  const FloatComplex *pa = a.data ();
+
+  octave_idx_type ii = 0;
+  xcidx (0) = 0;
+  for (octave_idx_type j = 0; j < nc; j++)
+    {
+      for (octave_idx_type i = 0; i < nr; i++)
+        {
+          FloatComplex val = pa[i+j*nr];
+          if (val != FloatComplex ())
+            {
+              xdata (ii) = val;
+              xridx (ii++) = i;
+            }
+        }
+      xcidx (j+1) = ii;
+    }
+}
+
 SparseComplexMatrix::SparseComplexMatrix (const ComplexDiagMatrix& a)
   : MSparse<Complex> (a.rows (), a.cols (), a.length ())
 {
@@ -81,6 +81,8 @@ public:
   explicit SparseComplexMatrix (const ComplexNDArray& a)
     : MSparse<Complex> (a) { }
 
+  explicit OCTAVE_API SparseComplexMatrix (const FloatComplexMatrix& a);
+
   SparseComplexMatrix (const Array<Complex>& a, const octave::idx_vector& r,
                        const octave::idx_vector& c, octave_idx_type nr = -1,
                        octave_idx_type nc = -1, bool sum_terms = true,
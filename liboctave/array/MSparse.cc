@@ -42,6 +42,27 @@ plus_or_minus (MSparse<T>& a, const MSparse<T>& b, OP op, const char *op_name)
   if (a_nr != b_nr || a_nc != b_nc)
     octave::err_nonconformant (op_name, a_nr, a_nc, b_nr, b_nc);
 
+  if (a.same_pattern (b))
+    {
+      // The pattern can only lose elements, so update the values in place.
+      octave_idx_type nz = a.nnz ();
+      T *ad = a.data ();
+      const T *bd = b.data ();
+      bool any_zero = false;
+
+      for (octave_idx_type i = 0; i < nz; i++)
+        {
+          ad[i] = op (ad[i], bd[i]);
+          if (ad[i] == T ())
+            any_zero = true;
+        }
+
+      if (any_zero)
+        a.maybe_compress (true);
+
+      return a;
+    }
+
   r = MSparse<T> (a_nr, a_nc, (a.nnz () + b.nnz ()));
 
   octave_idx_type jx = 0;
@@ -305,6 +326,31 @@ plus_or_minus (const MSparse<T>& a, const MSparse<T>& b, OP op,
     }
   else if (a_nr != b_nr || a_nc != b_nc)
     octave::err_nonconformant (op_name, a_nr, a_nc, b_nr, b_nc);
+  else if (a.same_pattern (b))
+    {
+      // Identical patterns need no merge.
+      octave_idx_type nz = a.nnz ();
+      r = MSparse<T> (a_nr, a_nc, nz);
+
+      octave_idx_type jx = 0;
+      r.cidx (0) = 0;
+      for (octave_idx_type i = 0 ; i < a_nc ; i++)
+        {
+          octave_quit ();
+          for (octave_idx_type j = a.cidx (i) ; j < a.cidx (i+1) ; j++)
+            {
+              if (op (a.data (j), b.data (j)) != 0.)
+                {
+                  r.data (jx) = op (a.data (j), b.data (j));
+                  r.ridx (jx) = a.ridx (j);
+                  jx++;
+                }
+            }
+          r.cidx (i+1) = jx;
+        }
+
+      r.maybe_compress ();
+    }
   else
     {
       r = MSparse<T> (a_nr, a_nc, (a.nnz () + b.nnz ()));
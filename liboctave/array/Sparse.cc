@@ -566,36 +566,109 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
       octave::idx_vector cc = c;
       const octave_idx_type *rd = rr.raw ();
       const octave_idx_type *cd = cc.raw ();
+      const T *ad = a.data ();
       OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, ci, nc+1, 0);
       ci[0] = 0;
-      // Bin counts of column indices.
-      for (octave_idx_type i = 0; i < n; i++)
-        ci[cd[i]+1]++;
-      // Make them cumulative, shifted one to right.
-      for (octave_idx_type i = 1, s = 0; i <= nc; i++)
-        {
-          octave_idx_type s1 = s + ci[i];
-          ci[i] = s;
-          s = s1;
-        }
-
-      octave_quit ();
 
       typedef std::pair<octave_idx_type, octave_idx_type> idx_pair;
-      // Bucket sort.
       OCTAVE_LOCAL_BUFFER (idx_pair, spairs, n);
-      for (octave_idx_type i = 0; i < n; i++)
+
+      // Assembling large matrices from triplets is shared among threads.
+      // For the bucket sort, each thread takes a contiguous part of the
+      // triplets and gets its own range in each bucket, so that buckets keep
+      // the order of the input.  This needs a count per thread and column,
+      // so fewer threads are used if there are many columns.
+      int nt = sparse_assembly_nthreads (n);
+      int nt_bucket = static_cast<int> (std::min<octave_idx_type>
+                                        (nt, n / (nc + 1)));
+
+      if (nt_bucket > 1)
         {
-          idx_pair& p = spairs[ci[cd[i]+1]++];
-          if (rl == 1)
-            p.first = rd[0];
-          else
-            p.first = rd[i];
-          p.second = i;
+          std::vector<octave_idx_type> tbeg (nt_bucket + 1);
+          for (int t = 0; t <= nt_bucket; t++)
+            tbeg[t] = (n / nt_bucket * t
+                       + std::min<octave_idx_type> (t, n % nt_bucket));
+
+          std::vector<octave_idx_type> tci (nt_bucket * nc, 0);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt_bucket)
+#endif
+          for (int t = 0; t < nt_bucket; t++)
+            {
+              octave_idx_type *tcit = tci.data () + t * nc;
+              for (octave_idx_type i = tbeg[t]; i < tbeg[t+1]; i++)
+                tcit[cd[i]]++;
+            }
+
+          // Start of the range of each thread in each bucket.
+          for (octave_idx_type j = 0; j < nc; j++)
+            {
+              octave_idx_type s = ci[j];
+              for (int t = 0; t < nt_bucket; t++)
+                {
+                  octave_idx_type s1 = s + tci[t * nc + j];
+                  tci[t * nc + j] = s;
+                  s = s1;
+                }
+              ci[j+1] = s;
+            }
+
+          octave_quit ();
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt_bucket)
+#endif
+          for (int t = 0; t < nt_bucket; t++)
+            {
+              octave_idx_type *tcit = tci.data () + t * nc;
+              for (octave_idx_type i = tbeg[t]; i < tbeg[t+1]; i++)
+                {
+                  idx_pair& p = spairs[tcit[cd[i]]++];
+                  if (rl == 1)
+                    p.first = rd[0];
+                  else
+                    p.first = rd[i];
+                  p.second = i;
+                }
+            }
         }
+      else
+        {
+          // Bin counts of column indices.
+          for (octave_idx_type i = 0; i < n; i++)
+            ci[cd[i]+1]++;
+          // Make them cumulative, shifted one to right.
+          for (octave_idx_type i = 1, s = 0; i <= nc; i++)
+            {
+              octave_idx_type s1 = s + ci[i];
+              ci[i] = s;
+              s = s1;
+            }
+
+          octave_quit ();
+
+          // Bucket sort.
+          for (octave_idx_type i = 0; i < n; i++)
+            {
+              idx_pair& p = spairs[ci[cd[i]+1]++];
+              if (rl == 1)
+                p.first = rd[0];
+              else
+                p.first = rd[i];
+              p.second = i;
+            }
+        }
+
+      octave_quit ();
 
       // Subsorts.  We don't need a stable sort, the second index stabilizes it.
-      xcidx (0) = 0;
+      octave_idx_type *rci = xcidx ();
+      rci[0] = 0;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt) schedule (dynamic, 256)
+#endif
       for (octave_idx_type j = 0; j < nc; j++)
         {
           std::sort (spairs + ci[j], spairs + ci[j+1]);
@@ -611,18 +684,27 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
                   nzj++;
                 }
             }
-          // Set column pointer.
-          xcidx (j+1) = xcidx (j) + nzj;
+          rci[j+1] = nzj;
         }
 
+      // Set column pointers.
+      for (octave_idx_type j = 0; j < nc; j++)
+        rci[j+1] += rci[j];
+
+      octave_quit ();
+
       change_capacity (nzm > xcidx (nc) ? nzm : xcidx (nc));
       octave_idx_type *rri = ridx ();
       T *rrd = data ();
+      rci = xcidx ();
 
       // Fill-in data.
-      for (octave_idx_type j = 0, jj = -1; j < nc; j++)
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt) schedule (dynamic, 256)
+#endif
+      for (octave_idx_type j = 0; j < nc; j++)
         {
-          octave_quit ();
+          octave_idx_type jj = rci[j] - 1;
           octave_idx_type l = -1;
           if (sum_terms)
             {
@@ -633,11 +715,11 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
                   if (k != l)
                     {
                       l = k;
-                      rrd[++jj] = a(spairs[i].second);
+                      rrd[++jj] = ad[spairs[i].second];
                       rri[jj] = k;
                     }
                   else
-                    rrd[jj] += a(spairs[i].second);
+                    rrd[jj] += ad[spairs[i].second];
                 }
             }
           else
@@ -651,11 +733,13 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
                       l = k;
                       rri[++jj] = k;
                     }
-                  rrd[jj] = a(spairs[i].second);
+                  rrd[jj] = ad[spairs[i].second];
                 }
             }
         }
 
+      octave_quit ();
+
       maybe_compress (true);
     }
 }
@@ -664,6 +748,17 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
 %!assert <*51880> (sparse (1:2, 2, 1:2, 2, 2), sparse ([0, 1; 0, 2]))
 %!assert <*51880> (sparse (1:2, 1, 1:2, 2, 2), sparse ([1, 0; 2, 0]))
 %!assert <*51880> (sparse (1:2, 2, 1:2, 2, 3), sparse ([0, 1, 0; 0, 2, 0]))
+
+## Large assemblies with repeated entries
+%!test
+%! n = 2e5;
+%! i = mod ((1:n)' * 7919, 97) + 1;
+%! j = mod ((1:n)' * 104729, 89) + 1;
+%! v = mod ((1:n)', 13) + 1;
+%! S = sparse (i, j, v, 97, 89);
+%! assert (full (S), accumarray ([i, j], v, [97, 89]));
+%! S = sparse (i, j, true, 97, 89);
+%! assert (full (S), accumarray ([i, j], 1, [97, 89]) > 0);
 */
 
 template <typename T, typename Alloc>
@@ -1191,6 +1286,21 @@ lblookup (const octave_idx_type *ridx, octave_idx_type nr,
     return std::lower_bound (ridx, ridx + nr, ri) - ridx;
 }
 
+// Position of element (RI, CJ) in the data of a sparse matrix with
+// column index CIDX and row index RIDX, or -1 if it is not stored.
+static
+octave_idx_type
+lookup_stored_element (const octave_idx_type *cidx,
+                       const octave_idx_type *ridx,
+                       octave_idx_type ri, octave_idx_type cj)
+{
+  octave_idx_type lo = cidx[cj];
+  octave_idx_type hi = cidx[cj+1];
+  octave_idx_type k = lo + lblookup (ridx + lo, hi - lo, ri);
+
+  return (k < hi && ridx[k] == ri) ? k : -1;
+}
+
 template <typename T, typename Alloc>
 OCTAVE_API
 void
@@ -1898,6 +2008,40 @@ Sparse<T, Alloc>::assign (const octave::idx_vector& idx,
         return;
 
       octave_idx_type nx = idx.extent (n);
+
+      if (nx == n && rhs.nnz () == rhl && ! idx.is_colon ())
+        {
+          // If every indexed element is already stored and no new value
+          // is zero, the sparsity pattern does not change.  This is the
+          // common case of updating the values of a matrix with a fixed
+          // pattern, as in A(find (A)) = v, and only the data is written.
+
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, pos, rhl);
+
+          bool same_pattern = true;
+          for (octave_idx_type i = 0; i < rhl; i++)
+            {
+              octave_idx_type ii = idx(i);
+              pos[i] = lookup_stored_element (cidx (), ridx (),
+                                              ii % nr, ii / nr);
+              if (pos[i] < 0)
+                {
+                  same_pattern = false;
+                  break;
+                }
+            }
+
+          if (same_pattern)
+            {
+              T *d = data ();
+              const T *rd = rhs.data ();
+              for (octave_idx_type i = 0; i < rhl; i++)
+                d[pos[i]] = rd[i];
+
+              return;
+            }
+        }
+
       // Try to resize first if necessary.
       if (nx != n)
         {
@@ -2106,6 +2250,42 @@ Sparse<T, Alloc>::assign (const octave::idx_vector& idx_i,
       if (n == 0 || m == 0)
         return;
 
+      if (rhs.nnz () == n * m && ! (idx_i.is_colon () && idx_j.is_colon ()))
+        {
+          // Overwriting elements that are all stored with nonzero values
+          // leaves the sparsity pattern unchanged, so write the data in
+          // place without rebuilding the index arrays.
+
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, pos, n * m);
+
+          bool same_pattern = true;
+          for (octave_idx_type j = 0; j < m && same_pattern; j++)
+            {
+              octave_idx_type jj = idx_j(j);
+              for (octave_idx_type i = 0; i < n; i++)
+                {
+                  octave_idx_type k
+                    = lookup_stored_element (cidx (), ridx (), idx_i(i), jj);
+                  if (k < 0)
+                    {
+                      same_pattern = false;
+                      break;
+                    }
+                  pos[j*n+i] = k;
+                }
+            }
+
+          if (same_pattern)
+            {
+              T *d = data ();
+              const T *rd = rhs.data ();
+              for (octave_idx_type k = 0; k < n * m; k++)
+                d[pos[k]] = rd[k];
+
+              return;
+            }
+        }
+
       if (idx_i.is_colon ())
         {
           octave_idx_type lb, ub;
@@ -3086,6 +3266,34 @@ read_sparse_matrix (std::istream& is, Sparse<T>& a,
 %! b(1,:) = (1:3)';
 %! assert (a, b);
 
+## Assignments that keep the sparsity pattern
+%!test
+%! a = sprandn (50, 40, 0.1);
+%! k = find (a);
+%! f = full (a);
+%! v = (1:numel (k))';
+%! a(k) = v;
+%! f(k) = v;
+%! assert (a, sparse (f));
+%! assert (nnz (a), numel (k));
+%! a(k(3)) = 0;
+%! f(k(3)) = 0;
+%! assert (a, sparse (f));
+%! assert (nnz (a), numel (k) - 1);
+%!test
+%! a = sparse (magic (4));
+%! b = a;
+%! a(2:3, [4, 1]) = [1, 2; 3, 4];
+%! assert (full (a), [16, 2, 3, 13; 2, 11, 10, 1; 4, 7, 6, 3; 4, 14, 15, 1]);
+%! assert (b, sparse (magic (4)));
+%!test
+%! a = sparse ([1, 0, 2; 0, 3, 0]);
+%! b = sparse ([4, 0, -2; 0, 5, 0]);
+%! assert (a + b, sparse ([5, 0, 0; 0, 8, 0]));
+%! assert (nnz (a + b), 2);
+%! assert (a - b, sparse ([-3, 0, 4; 0, -2, 0]));
+%! assert (a + 1i*b, sparse ([1+4i, 0, 2-2i; 0, 3+5i, 0]));
+
 */
 
 template <typename T, typename Alloc>
@@ -37,6 +37,7 @@
 #include "Array-fwd.h"
 #include "Sparse-fwd.h"
 #include "mx-fwd.h"
+#include "oct-alloc-stats.h"
 
 // Two dimensional sparse class.  Handles the reference counting for
 // all the derived classes.
@@ -123,7 +124,12 @@ protected:
                const Alloc& xallocator = Alloc ())
       : Alloc (xallocator), m_data (d), m_ridx (r), m_cidx (c),
         m_nzmax (nz), m_nrows (dv(0)), m_ncols (dv(1)), m_count (1)
-    { }
+    {
+      // Balance the accounting in the destructor for the adopted storage.
+      octave::alloc_stats::allocated (nz * sizeof (T)
+                                      + (nz + m_ncols + 1)
+                                        * sizeof (octave_idx_type));
+    }
 
     SparseRep (const SparseRep& a)
       : Alloc (), m_data (T_allocate (a.m_nzmax)),
@@ -193,6 +199,8 @@ protected:
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::construct (alloc, data+i);
 
+      octave::alloc_stats::allocated (len * sizeof (T));
+
       return data;
     }
 
@@ -203,6 +211,8 @@ protected:
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::destroy (alloc, data+i);
       T_Alloc_traits::deallocate (alloc, data, len);
+
+      octave::alloc_stats::freed (len * sizeof (T));
     }
 
     idx_type_pointer idx_type_allocate (size_t len)
@@ -213,6 +223,8 @@ protected:
       for (size_t i = 0; i < len; i++)
         idx_type_Alloc_traits::construct (alloc, idx+i);
 
+      octave::alloc_stats::allocated (len * sizeof (octave_idx_type));
+
       return idx;
     }
 
@@ -223,6 +235,8 @@ protected:
       for (size_t i = 0; i < len; i++)
         idx_type_Alloc_traits::destroy (alloc, idx+i);
       idx_type_Alloc_traits::deallocate (alloc, idx, len);
+
+      octave::alloc_stats::freed (len * sizeof (octave_idx_type));
     }
   };
 
@@ -745,6 +759,24 @@ public:
 
   bool indices_ok () const { return m_rep->indices_ok (); }
 
+  // True if B has the same dimensions and stores exactly the same
+  // elements, so that elementwise operations need not merge patterns.
+  template <typename U, typename A>
+  bool same_pattern (const Sparse<U, A>& b) const
+  {
+    octave_idx_type nc = cols ();
+    octave_idx_type nz = nnz ();
+
+    if (b.rows () != rows () || b.cols () != nc || b.nnz () != nz)
+      return false;
+
+    const octave_idx_type *bc = b.cidx ();
+    const octave_idx_type *br = b.ridx ();
+
+    return ((bc == cidx () || std::equal (bc, bc + nc + 1, cidx ()))
+            && (br == ridx () || std::equal (br, br + nz, ridx ())));
+  }
+
   bool any_element_is_nan () const
   { return m_rep->any_element_is_nan (); }
 };
@@ -40,6 +40,7 @@
 #include "oct-locbuf.h"
 
 #include "dDiagMatrix.h"
+#include "fMatrix.h"
 #include "CSparse.h"
 #include "boolSparse.h"
 #include "dSparse.h"
@@ -75,6 +76,32 @@ SparseMatrix::SparseMatrix (const SparseBoolMatrix& a)
     }
 }
 
+// Convert single precision data directly, without a full double copy.
+
+SparseMatrix::SparseMatrix (const FloatMatrix& a)
+  : MSparse<double> (a.rows (), a.cols (), a.nnz ())
+{
+  octave_idx_type nr = rows ();
+  octave_idx_type nc = cols ();
+  const float *pa = a.data ();
+
+  octave_idx_type ii = 0;
+  xcidx (0) = 0;
+  for (octave_idx_type j = 0; j < nc; j++)
+    {
+      for (octave_idx_type i = 0; i < nr; i++)
+        {
+          float val = pa[i+j*nr];
+          if (val != 0.0f)
+            {
+              xdata (ii) = val;
+              xridx (ii++) = i;
+            }
+        }
+      xcidx (j+1) = ii;
+    }
+}
+
 SparseMatrix::SparseMatrix (const DiagMatrix& a)
   : MSparse<double> (a.rows (), a.cols (), a.length ())
 {
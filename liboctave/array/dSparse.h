@@ -75,6 +75,8 @@ public:
 
   explicit SparseMatrix (const NDArray& a) : MSparse<double> (a) { }
 
+  explicit OCTAVE_API SparseMatrix (const FloatMatrix& a);
+
   SparseMatrix (const Array<double>& a, const octave::idx_vector& r,
                 const octave::idx_vector& c, octave_idx_type nr = -1,
                 octave_idx_type nc = -1, bool sum_terms = true,
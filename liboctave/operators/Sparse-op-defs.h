@@ -28,9 +28,16 @@
 
 #include "octave-config.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <utility>
+#include <vector>
+
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
 #include "mx-inlines.cc"
+#include "nproc-wrapper.h"
 #include "oct-locbuf.h"
 
 // sparse matrix by scalar operations.
@@ -436,6 +443,30 @@
       }                                                                 \
     else if (m1_nr != m2_nr || m1_nc != m2_nc)                          \
       octave::err_nonconformant (#F, m1_nr, m1_nc, m2_nr, m2_nc);               \
+    else if (m1.same_pattern (m2))                                      \
+      {                                                                 \
+        /* Identical patterns need no merge.  */                        \
+        r = R (m1_nr, m1_nc, m1.nnz ());                                \
+                                                                        \
+        octave_idx_type jx = 0;                                         \
+        r.cidx (0) = 0;                                                 \
+        for (octave_idx_type i = 0 ; i < m1_nc ; i++)                   \
+          {                                                             \
+            octave_quit ();                                             \
+            for (octave_idx_type j = m1.cidx (i) ; j < m1.cidx (i+1) ; j++) \
+              {                                                         \
+                if ((m1.data (j) OP m2.data (j)) != 0.)                 \
+                  {                                                     \
+                    r.data (jx) = m1.data (j) OP m2.data (j);           \
+                    r.ridx (jx) = m1.ridx (j);                          \
+                    jx++;                                               \
+                  }                                                     \
+              }                                                         \
+            r.cidx (i+1) = jx;                                          \
+          }                                                             \
+                                                                        \
+        r.maybe_compress ();                                            \
+      }                                                                 \
     else                                                                \
       {                                                                 \
         r = R (m1_nr, m1_nc, (m1.nnz () + m2.nnz ()));                  \
@@ -1760,6 +1791,299 @@
 
 #define SPARSE_ANY_OP(DIM) SPARSE_ANY_ALL_OP (DIM, false, false, !=, true)
 
+// Number of threads to use for a sparse product with WORK multiply-add
+// operations.  Small products are not worth the cost of starting threads.
+
+inline int
+sparse_mul_nthreads (double work)
+{
+#if defined (HAVE_OPENMP)
+  if (work >= 65536)
+    return octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+#else
+  octave_unused_parameter (work);
+#endif
+
+  return 1;
+}
+
+// Call FCN (WS, I) for I = 0, ..., N-1, sharing the iterations among NT
+// threads.  Each thread gets its own workspace WS, constructed from
+// WS_ARG.  Exceptions are caught in the threads and rethrown afterwards.
+
+template <typename WS, typename WS_ARG, typename F>
+void
+sparse_mul_parallel_for (octave_idx_type n, octave_idx_type nt,
+                         const WS_ARG& ws_arg, F fcn)
+{
+  if (nt <= 1)
+    {
+      WS ws (ws_arg);
+
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          octave_quit ();
+
+          fcn (ws, i);
+        }
+
+      return;
+    }
+
+  std::exception_ptr err;
+  std::atomic<bool> failed (false);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel num_threads (nt)
+#endif
+  {
+    WS ws (ws_arg);
+
+#if defined (HAVE_OPENMP)
+#  pragma omp for schedule (dynamic, 64)
+#endif
+    for (octave_idx_type i = 0; i < n; i++)
+      {
+        if (failed)
+          continue;
+
+        try
+          {
+            fcn (ws, i);
+          }
+        catch (...)
+          {
+#if defined (HAVE_OPENMP)
+#  pragma omp critical (sparse_mul_parallel_for)
+#endif
+            {
+              if (! err)
+                err = std::current_exception ();
+            }
+            failed = true;
+          }
+      }
+  }
+
+  if (err)
+    std::rethrow_exception (err);
+
+  octave_quit ();
+}
+
+// Per-thread scratch space for sparse_sparse_mul.  Columns of the result
+// that are sparse compared to the number of rows are accumulated by
+// sorting their contributions.  Only denser columns use a marker array and
+// dense accumulator, which are allocated the first time they are needed.
+
+template <typename T>
+class sparse_mul_workspace
+{
+public:
+
+  sparse_mul_workspace (octave_idx_type nr)
+    : m_nr (nr), m_mark (), m_acc (), m_rows (), m_entries ()
+  { }
+
+  bool use_dense (octave_idx_type flops) const
+  {
+    return flops > m_nr / 16;
+  }
+
+  void init_dense ()
+  {
+    if (m_mark.empty ())
+      {
+        m_mark.resize (m_nr, 0);
+        m_acc.resize (m_nr);
+      }
+  }
+
+  octave_idx_type m_nr;
+
+  std::vector<octave_idx_type> m_mark;
+  std::vector<T> m_acc;
+  std::vector<octave_idx_type> m_rows;
+  std::vector<std::pair<octave_idx_type, T>> m_entries;
+};
+
+// Sparse * sparse product M * A with Gustavson's algorithm.  A symbolic
+// pass computes the exact number of nonzeros in every column of the
+// result, so the output is allocated once at its final size.  The numeric
+// pass then fills in the columns independently.  Both passes share the
+// columns of the result among threads.
+
+template <typename RT, typename MT, typename AT>
+RT
+sparse_sparse_mul (const MT& m, const AT& a)
+{
+  typedef typename RT::element_type T;
+
+  const octave_idx_type nr = m.rows ();
+  const octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *mc = m.cidx ();
+  const octave_idx_type *mr = m.ridx ();
+  const auto *md = m.data ();
+
+  const octave_idx_type *ac = a.cidx ();
+  const octave_idx_type *ar = a.ridx ();
+  const auto *ad = a.data ();
+
+  // Number of multiply-adds for column I of the result, which is also an
+  // upper bound on its number of nonzeros.
+  auto col_flops = [=] (octave_idx_type i)
+  {
+    octave_idx_type f = 0;
+    for (octave_idx_type j = ac[i]; j < ac[i+1]; j++)
+      f += mc[ar[j]+1] - mc[ar[j]];
+    return f;
+  };
+
+  double flops = 0;
+  for (octave_idx_type j = 0; j < ac[a_nc]; j++)
+    flops += mc[ar[j]+1] - mc[ar[j]];
+
+  const octave_idx_type nt = sparse_mul_nthreads (flops);
+
+  RT retval (nr, a_nc, static_cast<octave_idx_type> (0));
+  octave_idx_type *rc = retval.xcidx ();
+  rc[0] = 0;
+
+  // Symbolic pass: count nonzeros in each column.
+  sparse_mul_parallel_for<sparse_mul_workspace<T>>
+    (a_nc, nt, nr, [=] (sparse_mul_workspace<T>& ws, octave_idx_type i)
+  {
+    octave_idx_type f = col_flops (i);
+    octave_idx_type n = 0;
+
+    if (! ws.use_dense (f))
+      {
+        ws.m_rows.clear ();
+        for (octave_idx_type j = ac[i]; j < ac[i+1]; j++)
+          for (octave_idx_type k = mc[ar[j]]; k < mc[ar[j]+1]; k++)
+            ws.m_rows.push_back (mr[k]);
+
+        std::sort (ws.m_rows.begin (), ws.m_rows.end ());
+        n = std::unique (ws.m_rows.begin (), ws.m_rows.end ())
+            - ws.m_rows.begin ();
+      }
+    else
+      {
+        ws.init_dense ();
+        for (octave_idx_type j = ac[i]; j < ac[i+1]; j++)
+          for (octave_idx_type k = mc[ar[j]]; k < mc[ar[j]+1]; k++)
+            {
+              octave_idx_type row = mr[k];
+              if (ws.m_mark[row] != i + 1)
+                {
+                  ws.m_mark[row] = i + 1;
+                  n++;
+                }
+            }
+      }
+
+    rc[i+1] = n;
+  });
+
+  for (octave_idx_type i = 0; i < a_nc; i++)
+    rc[i+1] += rc[i];
+
+  octave_idx_type nel = rc[a_nc];
+
+  if (nel == 0)
+    return RT (nr, a_nc);
+
+  retval.change_capacity (nel);
+  octave_idx_type *rr = retval.xridx ();
+  T *rd = retval.xdata ();
+
+  // Numeric pass: compute the values of each column.  Contributions to an
+  // element are summed in the same order in either branch.
+  sparse_mul_parallel_for<sparse_mul_workspace<T>>
+    (a_nc, nt, nr, [=] (sparse_mul_workspace<T>& ws, octave_idx_type i)
+  {
+    octave_idx_type f = col_flops (i);
+    octave_idx_type p = rc[i];
+
+    if (f == 0)
+      return;
+
+    if (! ws.use_dense (f))
+      {
+        ws.m_entries.clear ();
+        for (octave_idx_type j = ac[i]; j < ac[i+1]; j++)
+          {
+            auto tmpval = ad[j];
+            for (octave_idx_type k = mc[ar[j]]; k < mc[ar[j]+1]; k++)
+              ws.m_entries.emplace_back (mr[k], tmpval * md[k]);
+          }
+
+        std::stable_sort (ws.m_entries.begin (), ws.m_entries.end (),
+                          [] (const std::pair<octave_idx_type, T>& x,
+                              const std::pair<octave_idx_type, T>& y)
+                          { return x.first < y.first; });
+
+        for (const auto& e : ws.m_entries)
+          {
+            if (p > rc[i] && rr[p-1] == e.first)
+              rd[p-1] += e.second;
+            else
+              {
+                rr[p] = e.first;
+                rd[p++] = e.second;
+              }
+          }
+      }
+    else
+      {
+        ws.init_dense ();
+        ws.m_rows.clear ();
+        for (octave_idx_type j = ac[i]; j < ac[i+1]; j++)
+          {
+            auto tmpval = ad[j];
+            for (octave_idx_type k = mc[ar[j]]; k < mc[ar[j]+1]; k++)
+              {
+                octave_idx_type row = mr[k];
+                if (ws.m_mark[row] != i + 1)
+                  {
+                    ws.m_mark[row] = i + 1;
+                    ws.m_rows.push_back (row);
+                    ws.m_acc[row] = tmpval * md[k];
+                  }
+                else
+                  ws.m_acc[row] += tmpval * md[k];
+              }
+          }
+
+        // Collect the rows in order, either by scanning all markers or by
+        // sorting the list of rows, whichever is cheaper.
+        octave_idx_type n = ws.m_rows.size ();
+        if (8 * n > nr)
+          {
+            for (octave_idx_type k = 0; k < nr; k++)
+              if (ws.m_mark[k] == i + 1)
+                {
+                  rr[p] = k;
+                  rd[p++] = ws.m_acc[k];
+                }
+          }
+        else
+          {
+            std::sort (ws.m_rows.begin (), ws.m_rows.end ());
+            for (octave_idx_type row : ws.m_rows)
+              {
+                rr[p] = row;
+                rd[p++] = ws.m_acc[row];
+              }
+          }
+      }
+  });
+
+  retval.maybe_compress (true);
+  return retval;
+}
+
 #define SPARSE_SPARSE_MUL(RET_TYPE, RET_EL_TYPE, EL_TYPE)               \
   octave_idx_type nr = m.rows ();                                       \
   octave_idx_type nc = m.cols ();                                       \
@@ -1812,119 +2136,187 @@
   else if (nc != a_nr)                                                  \
     octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
   else                                                                  \
-    {                                                                   \
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, w, nr);                     \
-      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
-      for (octave_idx_type i = 0; i < nr; i++)                          \
-        w[i] = 0;                                                       \
-      retval.xcidx (0) = 0;                                             \
-                                                                        \
-      octave_idx_type nel = 0;                                          \
-                                                                        \
-      for (octave_idx_type i = 0; i < a_nc; i++)                        \
-        {                                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
-                {                                                       \
-                  if (w[m.ridx (k)] < i + 1)                            \
-                    {                                                   \
-                      w[m.ridx (k)] = i + 1;                            \
-                      nel++;                                            \
-                    }                                                   \
-                  octave_quit ();                                       \
-                }                                                       \
-            }                                                           \
-          retval.xcidx (i+1) = nel;                                     \
-        }                                                               \
-                                                                        \
-      if (nel == 0)                                                     \
-        return RET_TYPE (nr, a_nc);                                     \
-      else                                                              \
-        {                                                               \
-          for (octave_idx_type i = 0; i < nr; i++)                      \
-            w[i] = 0;                                                   \
-                                                                        \
-          OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                  \
-                                                                        \
-          retval.change_capacity (nel);                                 \
-          /* The optimal break-point as estimated from simulations */   \
-          /* Note that Mergesort is O(nz log(nz)) while searching all */ \
-          /* values is O(nr), where nz here is nonzero per row of */    \
-          /* length nr.  The test itself was then derived from the */   \
-          /* simulation with random square matrices and the observation */ \
-          /* of the number of nonzero elements in the output matrix */  \
-          /* it was found that the breakpoints were */                  \
-          /*   nr: 500  1000  2000  5000 10000 */                       \
-          /*   nz:   6    25    97   585  2202 */                       \
-          /* The below is a simplication of the 'polyfit'-ed parameters */ \
-          /* to these breakpoints */                                    \
-          octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :           \
-                                       (a_nc * a_nc) / 43000);          \
-          octave_idx_type ii = 0;                                       \
-          octave_idx_type *ri = retval.xridx ();                        \
-          octave_sort<octave_idx_type> sort;                            \
-                                                                        \
-          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
-            {                                                           \
-              if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)    \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  for (octave_idx_type k = 0; k < nr; k++)              \
-                    if (w[k] == i + 1)                                  \
-                      {                                                 \
-                        retval.xdata (ii) = Xcol[k];                    \
-                        retval.xridx (ii++) = k;                        \
-                      }                                                 \
-                }                                                       \
-              else                                                      \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              retval.xridx (ii++) = row;                \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
-                  for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
-                    retval.xdata (k) = Xcol[retval.xridx (k)];          \
-                }                                                       \
-            }                                                           \
-          retval.maybe_compress (true);                                 \
-          return retval;                                                \
-        }                                                               \
+    return sparse_sparse_mul<RET_TYPE> (m, a);
+
+// Compressed row form (RPTR, COLS, VALS) of the NR x NC sparse matrix A
+// given in compressed column form.  This is the compressed column form of
+// A.'.  The entries of each row are in the order of their columns.
+
+template <typename ST>
+void
+sparse_csc_to_csr (octave_idx_type nr, octave_idx_type nc,
+                   const octave_idx_type *cidx, const octave_idx_type *ridx,
+                   const ST *data, octave_idx_type *rptr,
+                   octave_idx_type *cols, ST *vals)
+{
+  std::fill_n (rptr, nr + 1, 0);
+
+  for (octave_idx_type k = 0; k < cidx[nc]; k++)
+    rptr[ridx[k] + 1]++;
+
+  for (octave_idx_type i = 0; i < nr; i++)
+    rptr[i+1] += rptr[i];
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, next, nr);
+  std::copy_n (rptr, nr, next);
+
+  for (octave_idx_type j = 0; j < nc; j++)
+    {
+      octave_quit ();
+
+      for (octave_idx_type k = cidx[j]; k < cidx[j+1]; k++)
+        {
+          octave_idx_type q = next[ridx[k]]++;
+          cols[q] = j;
+          vals[q] = data[k];
+        }
+    }
+}
+
+// Y += A * X, where A is an NR x NC sparse matrix in compressed row form
+// (RPTR, COLS, VALS), X is a full NC x NRHS matrix, and Y is a full
+// NR x NRHS matrix.  Rows of Y are distributed among threads.  Each
+// element of Y is computed by a single thread that adds the products in
+// the order of the columns of A, so the result is the same as that of the
+// serial product in compressed column form for any number of threads.
+
+template <typename T, typename ST, typename XT>
+void
+sparse_full_mul_rows (octave_idx_type nr, octave_idx_type nc,
+                      const octave_idx_type *rptr,
+                      const octave_idx_type *cols, const ST *vals,
+                      const XT *x, octave_idx_type nrhs, T *y)
+{
+  const octave_idx_type nt
+    = sparse_mul_nthreads (double (rptr[nr]) * nrhs);
+
+  for (octave_idx_type i = 0; i < nrhs; i++)
+    {
+      octave_quit ();
+
+      const XT *xi = x + i * nc;
+      T *yi = y + i * nr;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt) schedule (dynamic, 256) if (nt > 1)
+#endif
+      for (octave_idx_type r = 0; r < nr; r++)
+        {
+          T acc = yi[r];
+          for (octave_idx_type k = rptr[r]; k < rptr[r+1]; k++)
+            acc += xi[cols[k]] * vals[k];
+          yi[r] = acc;
+        }
+    }
+}
+
+// Y += A * X, where A is an NR x NC sparse matrix in compressed column form
+// and X and Y are full matrices with NRHS columns.
+//
+// Columns of Y are independent, so they are distributed among threads if
+// there are enough of them.  Otherwise a transient compressed row copy of
+// A is made and rows of Y are distributed among threads instead.  The
+// result does not depend on the number of threads in either case.
+//
+// Making the row copy costs about as much as a serial product, so callers
+// that multiply by the same matrix repeatedly should make the copy once
+// with sparse_csc_to_csr (or as A.') and call sparse_full_mul_rows.
+
+template <typename T, typename ST, typename XT>
+void
+sparse_full_mul (octave_idx_type nr, octave_idx_type nc,
+                 const octave_idx_type *cidx, const octave_idx_type *ridx,
+                 const ST *data, const XT *x, octave_idx_type nrhs, T *y)
+{
+  const octave_idx_type nz = cidx[nc];
+
+  const octave_idx_type nt = sparse_mul_nthreads (double (nz) * nrhs);
+
+  if (nt == 1)
+    {
+      for (octave_idx_type i = 0; i < nrhs; i++)
+        {
+          const XT *xi = x + i * nc;
+          T *yi = y + i * nr;
+
+          for (octave_idx_type j = 0; j < nc; j++)
+            {
+              octave_quit ();
+
+              XT tmpval = xi[j];
+              for (octave_idx_type k = cidx[j]; k < cidx[j+1]; k++)
+                yi[ridx[k]] += tmpval * data[k];
+            }
+        }
+    }
+  else if (nrhs >= nt)
+    {
+      octave_quit ();
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt) schedule (static)
+#endif
+      for (octave_idx_type i = 0; i < nrhs; i++)
+        {
+          const XT *xi = x + i * nc;
+          T *yi = y + i * nr;
+
+          for (octave_idx_type j = 0; j < nc; j++)
+            {
+              XT tmpval = xi[j];
+              for (octave_idx_type k = cidx[j]; k < cidx[j+1]; k++)
+                yi[ridx[k]] += tmpval * data[k];
+            }
+        }
     }
+  else
+    {
+      std::vector<octave_idx_type> rptr (nr + 1);
+      std::vector<octave_idx_type> cols (nz);
+      std::vector<ST> vals (nz);
+
+      sparse_csc_to_csr (nr, nc, cidx, ridx, data, rptr.data (),
+                         cols.data (), vals.data ());
+
+      sparse_full_mul_rows (nr, nc, rptr.data (), cols.data (), vals.data (),
+                            x, nrhs, y);
+    }
+}
+
+// Y = op (A).' * X, where A is an NR x NC sparse matrix in compressed
+// column form, X is a full NR x NRHS matrix, and Y is a full NC x NRHS
+// matrix.  Every element of Y is an independent dot product, so columns of
+// A are simply distributed among threads.
+
+template <typename T, typename ST, typename XT, typename OP>
+void
+sparse_full_trans_mul (octave_idx_type nr, octave_idx_type nc,
+                       const octave_idx_type *cidx,
+                       const octave_idx_type *ridx, const ST *data,
+                       const XT *x, octave_idx_type nrhs, T *y, OP op)
+{
+  const octave_idx_type nt
+    = sparse_mul_nthreads (double (cidx[nc]) * nrhs);
+
+  for (octave_idx_type i = 0; i < nrhs; i++)
+    {
+      octave_quit ();
+
+      const XT *xi = x + i * nr;
+      T *yi = y + i * nc;
+
+#if defined (HAVE_OPENMP)
+#  pragma omp parallel for num_threads (nt) schedule (dynamic, 256) if (nt > 1)
+#endif
+      for (octave_idx_type j = 0; j < nc; j++)
+        {
+          T acc = T ();
+          for (octave_idx_type k = cidx[j]; k < cidx[j+1]; k++)
+            acc += xi[ridx[k]] * op (data[k]);
+          yi[j] = acc;
+        }
+    }
+}
 
 #define SPARSE_FULL_MUL(RET_TYPE, EL_TYPE)                              \
   octave_idx_type nr = m.rows ();                                       \
@@ -1946,17 +2338,9 @@
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < a_nr; j++)                    \
-            {                                                           \
-              octave_quit ();                                           \
+      sparse_full_mul (nr, nc, m.cidx (), m.ridx (), m.data (),         \
+                       a.data (), a_nc, retval.fortran_vec ());         \
                                                                         \
-              EL_TYPE tmpval = a.elem (j,i);                            \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                retval.elem (m.ridx (k),i) += tmpval * m.data (k);      \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -1978,18 +2362,11 @@
     {                                                                   \
       RET_TYPE retval (nc, a_nc);                                       \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < nc; j++)                      \
-            {                                                           \
-              octave_quit ();                                           \
+      sparse_full_trans_mul (nr, nc, m.cidx (), m.ridx (), m.data (),   \
+                             a.data (), a_nc, retval.fortran_vec (),    \
+                             [] (const auto& v) -> EL_TYPE              \
+                             { return CONJ_OP (v); });                  \
                                                                         \
-              EL_TYPE acc = EL_TYPE ();                                 \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));    \
-              retval.xelem (j,i) = acc;                                 \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -28,8 +28,11 @@
 #endif
 
 #include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined (HAVE_PCRE2)
@@ -107,13 +110,76 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 static bool lookbehind_warned = false;
 
+// Least recently used cache of compiled patterns, so that calling regexp
+// repeatedly with the same pattern does not compile it every time.  The
+// key is the pattern and the PCRE options.
+
+// FIXME: should the size be configurable?
+#define REGEXP_CACHE_SIZE 64
+
+struct compiled_regexp
+{
+  std::shared_ptr<void> m_code;
+  string_vector m_named_pats;
+  int m_names;
+  Array<int> m_named_idx;
+};
+
+typedef std::pair<std::string, int> regexp_cache_key;
+
+typedef std::list<std::pair<regexp_cache_key, compiled_regexp>>
+  regexp_cache_list;
+
+static regexp_cache_list regexp_cache;
+
+static std::map<regexp_cache_key, regexp_cache_list::iterator>
+  regexp_cache_index;
+
+static std::mutex regexp_cache_mutex;
+
+static bool
+regexp_cache_lookup (const regexp_cache_key& key, compiled_regexp& rx)
+{
+  std::lock_guard<std::mutex> lock (regexp_cache_mutex);
+
+  auto p = regexp_cache_index.find (key);
+
+  if (p == regexp_cache_index.end ())
+    return false;
+
+  // Move the entry to the front of the list.
+  regexp_cache.splice (regexp_cache.begin (), regexp_cache, p->second);
+
+  rx = p->second->second;
+
+  return true;
+}
+
+static void
+regexp_cache_insert (const regexp_cache_key& key, const compiled_regexp& rx)
+{
+  std::lock_guard<std::mutex> lock (regexp_cache_mutex);
+
+  if (regexp_cache_index.find (key) != regexp_cache_index.end ())
+    return;
+
+  regexp_cache.emplace_front (key, rx);
+  regexp_cache_index[key] = regexp_cache.begin ();
+
+  if (regexp_cache.size () > REGEXP_CACHE_SIZE)
+    {
+      regexp_cache_index.erase (regexp_cache.back ().first);
+      regexp_cache.pop_back ();
+    }
+}
+
 // FIXME: don't bother collecting and composing return values
 //        the user doesn't want.
 
 void
 regexp::free ()
 {
-  octave_pcre_code_free (static_cast<octave_pcre_code *> (m_code));
+  m_code.reset ();
 }
 
 void
@@ -122,6 +188,31 @@ regexp::compile_internal ()
   // If we had a previously compiled pattern, release it.
   free ();
 
+  m_named_pats = string_vector ();
+  m_names = 0;
+  m_named_idx = Array<int> ();
+
+  int pcre_options
+    = (  (m_options.case_insensitive () ? OCTAVE_PCRE_CASELESS : 0)
+         | (m_options.dotexceptnewline () ? 0 : OCTAVE_PCRE_DOTALL)
+         | (m_options.lineanchors () ? OCTAVE_PCRE_MULTILINE : 0)
+         | (m_options.freespacing () ? OCTAVE_PCRE_EXTENDED : 0)
+         | OCTAVE_PCRE_UTF);
+
+  regexp_cache_key key (m_pattern, pcre_options);
+
+  compiled_regexp cached;
+
+  if (regexp_cache_lookup (key, cached))
+    {
+      m_code = cached.m_code;
+      m_named_pats = cached.m_named_pats;
+      m_names = cached.m_names;
+      m_named_idx = cached.m_named_idx;
+
+      return;
+    }
+
   std::size_t max_length = MAXLOOKBEHIND;
 
   std::size_t pos = 0;
@@ -277,22 +368,17 @@ regexp::compile_internal ()
   while ((pos = buf_str.find ('\0')) != std::string::npos)
     buf_str.replace (pos, 1, "\\000");
 
-  int pcre_options
-    = (  (m_options.case_insensitive () ? OCTAVE_PCRE_CASELESS : 0)
-         | (m_options.dotexceptnewline () ? 0 : OCTAVE_PCRE_DOTALL)
-         | (m_options.lineanchors () ? OCTAVE_PCRE_MULTILINE : 0)
-         | (m_options.freespacing () ? OCTAVE_PCRE_EXTENDED : 0)
-         | OCTAVE_PCRE_UTF);
+  octave_pcre_code *code;
 
 #if defined (HAVE_PCRE2)
   PCRE2_SIZE erroffset;
   int errnumber;
 
-  m_code = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
-                          PCRE2_ZERO_TERMINATED, pcre_options,
-                          &errnumber, &erroffset, nullptr);
+  code = pcre2_compile (reinterpret_cast<PCRE2_SPTR> (buf_str.c_str ()),
+                        PCRE2_ZERO_TERMINATED, pcre_options,
+                        &errnumber, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     {
       // PCRE docs say:
       //
@@ -310,17 +396,30 @@ regexp::compile_internal ()
         ("%s: %s at position %zu of expression", m_who.c_str (), err,
          erroffset);
     }
+
+  // Compile the pattern to machine code for faster matching.  This fails
+  // harmlessly if PCRE2 was built without JIT support, and the pattern is
+  // then interpreted as before.
+  pcre2_jit_compile (code, PCRE2_JIT_COMPLETE);
 #else
   const char *err;
   int erroffset;
 
-  m_code = pcre_compile (buf_str.c_str (), pcre_options,
-                         &err, &erroffset, nullptr);
+  code = pcre_compile (buf_str.c_str (), pcre_options,
+                       &err, &erroffset, nullptr);
 
-  if (! m_code)
+  if (! code)
     (*current_liboctave_error_handler)
       ("%s: %s at position %d of expression", m_who.c_str (), err, erroffset);
 #endif
+
+  m_code = std::shared_ptr<void> (code, [] (void *p)
+    {
+      octave_pcre_code_free (static_cast<octave_pcre_code *> (p));
+    });
+
+  regexp_cache_insert (key, compiled_regexp {m_code, m_named_pats, m_names,
+                                             m_named_idx});
 }
 
 regexp::match_data
@@ -342,7 +441,7 @@ regexp::match (const std::string& buffer) const
   char *nametable;
   std::size_t idx = 0;
 
-  octave_pcre_code *re = static_cast<octave_pcre_code *> (m_code);
+  octave_pcre_code *re = static_cast<octave_pcre_code *> (m_code.get ());
 
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_CAPTURECOUNT, &subpatterns);
   octave_pcre_pattern_info (re, OCTAVE_PCRE_INFO_NAMECOUNT, &namecount);
@@ -363,21 +462,33 @@ regexp::match (const std::string& buffer) const
                 | static_cast<int> (nametable[i*nameentrysize+1]);
     }
 
+#if defined (HAVE_PCRE2)
+  // The match data block is reused for all matches in BUFFER.
+  pcre2_match_data *tmp_match_data
+    = pcre2_match_data_create_from_pattern (re, nullptr);
+
+  unwind_action cleanup_match_data ([tmp_match_data] () { pcre2_match_data_free (tmp_match_data); });
+#endif
+
   while (true)
     {
       octave_quit ();
 
 #if defined (HAVE_PCRE2)
-      pcre2_match_data *tmp_match_data
-        = pcre2_match_data_create_from_pattern (re, nullptr);
-
-      unwind_action cleanup_match_data ([tmp_match_data] () { pcre2_match_data_free (tmp_match_data); });
+      int match_options = PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0);
 
       int matches = pcre2_match (re, reinterpret_cast<PCRE2_SPTR> (buffer.c_str ()),
-                                 buffer.length (), idx,
-                                 PCRE2_NO_UTF_CHECK | (idx ? PCRE2_NOTBOL : 0),
+                                 buffer.length (), idx, match_options,
                                  tmp_match_data, nullptr);
 
+      // The stack of JIT compiled code is small.  The interpreter uses
+      // the heap, so try again with that.
+      if (matches == PCRE2_ERROR_JIT_STACKLIMIT)
+        matches = pcre2_match (re, reinterpret_cast<PCRE2_SPTR> (buffer.c_str ()),
+                               buffer.length (), idx,
+                               match_options | PCRE2_NO_JIT,
+                               tmp_match_data, nullptr);
+
       if (matches < 0 && matches != PCRE2_ERROR_NOMATCH)
         (*current_liboctave_error_handler)
           ("%s: internal error calling pcre2_match; "
@@ -29,6 +29,7 @@
 #include "octave-config.h"
 
 #include <list>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -221,8 +222,9 @@ private:
 
   opts m_options;
 
-  // Internal data describing the regular expression.
-  void *m_code;
+  // Internal data describing the regular expression.  Compiled patterns
+  // are cached and may be shared by several regexp objects.
+  std::shared_ptr<void> m_code;
 
   string_vector m_named_pats;
   int m_names;
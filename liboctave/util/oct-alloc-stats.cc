@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+
+#include "oct-alloc-stats.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+std::atomic<bool> alloc_stats::s_enabled (false);
+
+std::atomic<std::size_t> alloc_stats::s_bytes_allocated (0);
+std::atomic<std::size_t> alloc_stats::s_bytes_freed (0);
+std::atomic<std::size_t> alloc_stats::s_allocations (0);
+
+std::atomic<std::ptrdiff_t> alloc_stats::s_live_bytes (0);
+std::atomic<std::ptrdiff_t> alloc_stats::s_peak_bytes (0);
+
+static void
+update_peak (std::atomic<std::ptrdiff_t>& peak, std::ptrdiff_t value)
+{
+  std::ptrdiff_t old_peak = peak.load (std::memory_order_relaxed);
+
+  while (value > old_peak
+         && ! peak.compare_exchange_weak (old_peak, value,
+                                          std::memory_order_relaxed))
+    ;
+}
+
+void
+alloc_stats::set_peak (std::ptrdiff_t value)
+{
+  s_peak_bytes.store (std::max (value, live_bytes ()),
+                      std::memory_order_relaxed);
+}
+
+void
+alloc_stats::record_allocation (std::size_t bytes)
+{
+  s_bytes_allocated.fetch_add (bytes, std::memory_order_relaxed);
+  s_allocations.fetch_add (1, std::memory_order_relaxed);
+
+  std::ptrdiff_t n = static_cast<std::ptrdiff_t> (bytes);
+
+  std::ptrdiff_t live = s_live_bytes.fetch_add (n, std::memory_order_relaxed);
+
+  update_peak (s_peak_bytes, live + n);
+}
+
+void
+alloc_stats::record_deallocation (std::size_t bytes)
+{
+  s_bytes_freed.fetch_add (bytes, std::memory_order_relaxed);
+  s_live_bytes.fetch_sub (static_cast<std::ptrdiff_t> (bytes),
+                          std::memory_order_relaxed);
+}
+
+OCTAVE_END_NAMESPACE(octave)
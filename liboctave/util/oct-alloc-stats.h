@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_alloc_stats_h)
+#define octave_oct_alloc_stats_h 1
+
+#include "octave-config.h"
+
+#include <atomic>
+#include <cstddef>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Optional accounting of the memory allocated for the elements of Array
+// and Sparse objects.  The profiler enables it to attribute allocations to
+// the functions that make them.  If it is disabled, the cost is a single
+// test per allocation.  The counters are atomic because arrays may also be
+// created and destroyed by worker threads.
+
+class OCTAVE_API alloc_stats
+{
+public:
+
+  static bool enabled ()
+  { return s_enabled.load (std::memory_order_relaxed); }
+
+  static void enable (bool value)
+  { s_enabled.store (value, std::memory_order_relaxed); }
+
+  static void allocated (std::size_t bytes)
+  {
+    if (enabled ())
+      record_allocation (bytes);
+  }
+
+  static void freed (std::size_t bytes)
+  {
+    if (enabled ())
+      record_deallocation (bytes);
+  }
+
+  // Totals since the start of the session.  Only allocations made while
+  // the accounting was enabled are counted.
+
+  static std::size_t bytes_allocated ()
+  { return s_bytes_allocated.load (std::memory_order_relaxed); }
+
+  static std::size_t bytes_freed ()
+  { return s_bytes_freed.load (std::memory_order_relaxed); }
+
+  static std::size_t allocations ()
+  { return s_allocations.load (std::memory_order_relaxed); }
+
+  // Bytes allocated minus bytes freed.  This may be negative if memory
+  // that was allocated before the accounting was enabled is freed.
+
+  static std::ptrdiff_t live_bytes ()
+  { return s_live_bytes.load (std::memory_order_relaxed); }
+
+  // Highest value of live_bytes since the last call to set_peak.
+
+  static std::ptrdiff_t peak_bytes ()
+  { return s_peak_bytes.load (std::memory_order_relaxed); }
+
+  // Restart tracking the peak at the larger of VALUE and the current
+  // number of live bytes.
+
+  static void set_peak (std::ptrdiff_t value);
+
+private:
+
+  static void record_allocation (std::size_t bytes);
+
+  static void record_deallocation (std::size_t bytes);
+
+  static std::atomic<bool> s_enabled;
+
+  static std::atomic<std::size_t> s_bytes_allocated;
+  static std::atomic<std::size_t> s_bytes_freed;
+  static std::atomic<std::size_t> s_allocations;
+
+  static std::atomic<std::ptrdiff_t> s_live_bytes;
+  static std::atomic<std::ptrdiff_t> s_peak_bytes;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
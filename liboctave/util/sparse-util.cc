@@ -32,6 +32,7 @@
 #include <cstdio>
 
 #include "lo-error.h"
+#include "nproc-wrapper.h"
 #include "oct-sparse.h"
 #include "sparse-util.h"
 
@@ -131,3 +132,72 @@ sparse_indices_ok (octave_idx_type *r, octave_idx_type *c,
 
   return true;
 }
+
+octave_idx_type
+sparse_level_order (octave_idx_type n, const octave_idx_type *level,
+                    std::vector<octave_idx_type>& ptr,
+                    std::vector<octave_idx_type>& order)
+{
+  octave_idx_type nlevels = 0;
+  for (octave_idx_type k = 0; k < n; k++)
+    if (level[k] >= nlevels)
+      nlevels = level[k] + 1;
+
+  ptr.assign (nlevels + 1, 0);
+  for (octave_idx_type k = 0; k < n; k++)
+    ptr[level[k]+1]++;
+  for (octave_idx_type l = 0; l < nlevels; l++)
+    ptr[l+1] += ptr[l];
+
+  std::vector<octave_idx_type> next (ptr.begin (), ptr.end () - 1);
+  order.resize (n);
+  for (octave_idx_type k = 0; k < n; k++)
+    order[next[level[k]]++] = k;
+
+  return nlevels;
+}
+
+int
+sparse_level_nthreads (octave_idx_type nnz, octave_idx_type n,
+                       octave_idx_type nlevels)
+{
+#if defined (HAVE_OPENMP)
+  if (nnz >= 65536 && nlevels > 0 && n / nlevels >= 64)
+    return octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+#else
+  octave_unused_parameter (nnz);
+  octave_unused_parameter (n);
+  octave_unused_parameter (nlevels);
+#endif
+
+  return 1;
+}
+
+int
+sparse_level_workspace_nthreads (int nt, octave_idx_type nnz,
+                                 octave_idx_type n, std::size_t value_size)
+{
+  if (nt <= 1 || n <= 0)
+    return 1;
+
+  double max_nt = (double (nnz) * (sizeof (octave_idx_type) + value_size)
+                   / (double (n) * sizeof (octave_idx_type)));
+
+  if (max_nt < nt)
+    nt = (max_nt < 1 ? 1 : static_cast<int> (max_nt));
+
+  return nt;
+}
+
+int
+sparse_assembly_nthreads (octave_idx_type n)
+{
+#if defined (HAVE_OPENMP)
+  if (n >= 65536)
+    return octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+#else
+  octave_unused_parameter (n);
+#endif
+
+  return 1;
+}
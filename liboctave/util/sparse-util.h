@@ -28,6 +28,9 @@
 
 #include "octave-config.h"
 
+#include <cstddef>
+#include <vector>
+
 // The next two functions don't do anything unless CHOLMOD is available
 
 // FIXME: This overload is here due to API change in SuiteSparse (3.1 -> 3.2)
@@ -45,4 +48,38 @@ sparse_indices_ok (octave_idx_type *r, octave_idx_type *c,
                    octave_idx_type nrows, octave_idx_type ncols,
                    octave_idx_type nnz);
 
+// Level scheduling for sparse triangular factorizations and solves.
+// LEVEL[K] is the level of column K, one more than the highest level of
+// the columns that column K depends on.  Sort the N columns by level into
+// ORDER and return the number of levels.  The columns of level L are
+// ORDER[PTR[L]] to ORDER[PTR[L+1]-1], in increasing order.
+
+extern OCTAVE_API octave_idx_type
+sparse_level_order (octave_idx_type n, const octave_idx_type *level,
+                    std::vector<octave_idx_type>& ptr,
+                    std::vector<octave_idx_type>& order);
+
+// Number of threads for a level-scheduled computation with NNZ nonzero
+// elements in N columns that form NLEVELS levels.  Return 1 if there is too
+// little work or the levels are too narrow for threads to pay off.
+
+extern OCTAVE_API int
+sparse_level_nthreads (octave_idx_type nnz, octave_idx_type n,
+                       octave_idx_type nlevels);
+
+// Limit the number NT of threads of a level-scheduled factorization with
+// NNZ nonzero elements in N columns, in which every thread needs a work
+// array of N indices.  The work arrays of all threads together take no more
+// memory than the indices and values, of VALUE_SIZE bytes each, of the
+// factor.  Return 1 if that leaves no room for more than one thread.
+
+extern OCTAVE_API int
+sparse_level_workspace_nthreads (int nt, octave_idx_type nnz,
+                                 octave_idx_type n, std::size_t value_size);
+
+// Number of threads for assembling a sparse matrix from N triplets.
+
+extern OCTAVE_API int
+sparse_assembly_nthreads (octave_idx_type n);
+
 #endif
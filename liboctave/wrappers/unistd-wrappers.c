@@ -112,6 +112,12 @@ octave_ctermid_wrapper (void)
 #endif
 }
 
+int
+octave_dup_wrapper (int fd)
+{
+  return dup (fd);
+}
+
 int
 octave_dup2_wrapper (int fd1, int fd2)
 {
@@ -314,6 +320,12 @@ octave_link_wrapper (const char *nm1, const char *nm2)
   return link (nm1, nm2);
 }
 
+off_t
+octave_lseek_wrapper (int fd, off_t offset, int whence)
+{
+  return lseek (fd, offset, whence);
+}
+
 int
 octave_pipe_wrapper (int *fd)
 {
@@ -52,6 +52,8 @@ extern OCTAVE_API int octave_close_wrapper (int fd);
 
 extern OCTAVE_API const char * octave_ctermid_wrapper (void);
 
+extern OCTAVE_API int octave_dup_wrapper (int fd);
+
 extern OCTAVE_API int octave_dup2_wrapper (int fd1, int fd2);
 
 extern OCTAVE_API int octave_execv_wrapper (const char *file, char *const *argv);
@@ -84,6 +86,9 @@ extern OCTAVE_API int octave_isatty_wrapper (int fd);
 
 extern OCTAVE_API int octave_link_wrapper (const char *nm1, const char *nm2);
 
+extern OCTAVE_API off_t octave_lseek_wrapper (int fd, off_t offset,
+                                              int whence);
+
 extern OCTAVE_API int octave_pipe_wrapper (int *fd);
 
 extern OCTAVE_API int octave_rmdir_wrapper (const char *nm);
@@ -724,7 +724,6 @@ function rlist = missing_functions ()
   "ddensd",
   "ddesd",
   "ddeset",
-  "decomposition",
   "degree",
   "delaunayTriangulation",
   "deleteCol",
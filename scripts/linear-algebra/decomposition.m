@@ -0,0 +1,464 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef decomposition
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{dA} =} decomposition (@var{A})
+  ## @deftypefnx {} {@var{dA} =} decomposition (@var{A}, @var{type})
+  ## Compute a factorization of the matrix @var{A} that can be reused to solve
+  ## linear systems with @var{A}.
+  ##
+  ## The object @var{dA} is used in place of @var{A} with the operators
+  ## @code{\} and @code{/}.  @code{@var{dA} \ @var{B}} and
+  ## @code{@var{B} / @var{dA}} return the same result as
+  ## @code{@var{A} \ @var{B}} and @code{@var{B} / @var{A}}, but the
+  ## factorization of @var{A} is only computed once, however many right-hand
+  ## sides are solved for.
+  ##
+  ## @var{type} selects the factorization and is one of
+  ##
+  ## @table @asis
+  ## @item @qcode{"auto"} (default)
+  ## Use @qcode{"chol"} if @var{A} is Hermitian with a positive real
+  ## diagonal and the Cholesky@tie{}factorization succeeds, @qcode{"lu"} for
+  ## other square matrices, and @qcode{"qr"} for rectangular matrices.
+  ##
+  ## @item @qcode{"lu"}
+  ## LU@tie{}factorization with partial pivoting.  For sparse @var{A}, the
+  ## columns are reordered to reduce fill-in.
+  ##
+  ## @item @qcode{"chol"}
+  ## Cholesky@tie{}factorization of a Hermitian positive definite matrix.  For
+  ## sparse @var{A}, rows and columns are reordered to reduce fill-in.
+  ##
+  ## @item @qcode{"qr"}
+  ## QR@tie{}factorization for least squares problems.  @var{A} must have at
+  ## least as many rows as columns.  For sparse @var{A}, the orthogonal factor
+  ## is not formed and systems are solved with the semi-normal equations and
+  ## one step of iterative refinement.
+  ##
+  ## @item @qcode{"banded"}
+  ## LU@tie{}factorization with partial pivoting that keeps the original
+  ## column order, so that the factors of a banded matrix stay banded.
+  ## @end table
+  ##
+  ## The factorization of a new matrix with the same size and sparsity pattern
+  ## is computed with
+  ##
+  ## @example
+  ## @var{dA} = refactor (@var{dA}, @var{A2})
+  ## @end example
+  ##
+  ## @noindent
+  ## which reuses the fill-reducing ordering computed for the original matrix.
+  ## This is much cheaper than creating a new object when the same sparse
+  ## system is solved many times with changing values, for example in each
+  ## step of a time integration.
+  ##
+  ## Example:
+  ##
+  ## @example
+  ## @group
+  ## A = gallery ("poisson", 100);
+  ## dA = decomposition (A);
+  ## x = zeros (rows (A), 1);
+  ## for k = 1:100
+  ##   x = dA \ (x + 1);
+  ## endfor
+  ## @end group
+  ## @end example
+  ##
+  ## @seealso{mldivide, mrdivide, linsolve, lu, chol, qr, matrix_type}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+    MatrixSize = [0, 0];
+    Type = "";
+  endproperties
+
+  properties (Access = private)
+    IsSparse = false;
+    ## Triangular factors, marked with their matrix type so that solves
+    ## don't probe their structure.  For the Cholesky and sparse QR
+    ## factorizations, L is the transpose of U.
+    L = [];
+    U = [];
+    ## Orthogonal factor of a full QR factorization, or the column permuted
+    ## matrix of a sparse QR factorization.
+    Q = [];
+    ## Row and column permutation vectors.  Empty if not used.
+    p = [];
+    q = [];
+  endproperties
+
+  methods
+
+    function dA = decomposition (A, type = "auto")
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (! (isfloat (A) && ndims (A) == 2))
+        error ("decomposition: A must be a 2-D floating point matrix");
+      endif
+      if (! ischar (type))
+        error ("decomposition: TYPE must be a string");
+      endif
+
+      type = tolower (type);
+      [m, n] = size (A);
+      is_auto = strcmp (type, "auto");
+
+      switch (type)
+        case "auto"
+          if (m != n)
+            type = "qr";
+          elseif (ishermitian (A) && all (real (diag (A)) > 0))
+            type = "chol";
+          else
+            type = "lu";
+          endif
+
+        case {"lu", "chol", "banded"}
+          if (m != n)
+            error ('decomposition: A must be square for TYPE "%s"', type);
+          endif
+
+        case "qr"
+          if (m < n)
+            error ('decomposition: A must not have more columns than rows for TYPE "qr"');
+          endif
+
+        otherwise
+          error ('decomposition: unknown TYPE "%s"', type);
+      endswitch
+
+      dA.MatrixSize = [m, n];
+      dA.IsSparse = issparse (A);
+      dA.Type = type;
+
+      [dA, ok] = factorize (dA, A, false);
+
+      if (! ok)
+        if (! is_auto)
+          error ("decomposition: A must be Hermitian positive definite for TYPE \"chol\"");
+        endif
+        ## Positive diagonal, but not positive definite.
+        dA.Type = "lu";
+        dA = factorize (dA, A, false);
+      endif
+
+    endfunction
+
+    function dA = refactor (dA, A)
+
+      ## -*- texinfo -*-
+      ## @deftypefn {} {@var{dA} =} refactor (@var{dA}, @var{A})
+      ## Factorize the matrix @var{A} with the type and the fill-reducing
+      ## ordering of the existing factorization @var{dA}.
+      ##
+      ## @var{A} must have the same size and storage class (full or sparse) as
+      ## the matrix that @var{dA} was created from and should have the same
+      ## sparsity pattern.  A different pattern still gives correct results,
+      ## but the reused ordering may cause more fill-in.
+      ## @end deftypefn
+
+      if (nargin != 2)
+        print_usage ();
+      endif
+
+      if (! isfloat (A) || ! isequal (size (A), dA.MatrixSize)
+          || issparse (A) != dA.IsSparse)
+        error ("refactor: A must match the size and sparsity of the factorized matrix");
+      endif
+
+      [dA, ok] = factorize (dA, A, true);
+
+      if (! ok)
+        error ("refactor: A must be Hermitian positive definite for TYPE \"chol\"");
+      endif
+
+    endfunction
+
+    function X = mldivide (dA, B)
+
+      [m, n] = deal (dA.MatrixSize(1), dA.MatrixSize(2));
+      if (rows (B) != m)
+        error ("Octave:nonconformant-args",
+               "operator \\: nonconformant arguments (op1 is %dx%d, op2 is %dx%d)",
+               m, n, rows (B), columns (B));
+      endif
+
+      switch (dA.Type)
+        case {"lu", "banded"}
+          X = dA.U \ (dA.L \ B(dA.p,:));
+          if (! isempty (dA.q))
+            X(dA.q,:) = X;
+          endif
+
+        case "chol"
+          if (isempty (dA.q))
+            X = dA.U \ (dA.L \ B);
+          else
+            X = dA.U \ (dA.L \ B(dA.q,:));
+            X(dA.q,:) = X;
+          endif
+
+        case "qr"
+          if (dA.IsSparse)
+            ## Corrected semi-normal equations.
+            X = dA.U \ (dA.L \ (dA.Q' * B));
+            X += dA.U \ (dA.L \ (dA.Q' * (B - dA.Q * X)));
+          else
+            X = dA.U \ (dA.Q' * B);
+          endif
+          X(dA.q,:) = X;
+      endswitch
+
+    endfunction
+
+    function X = mrdivide (B, dA)
+
+      [m, n] = deal (dA.MatrixSize(1), dA.MatrixSize(2));
+      if (columns (B) != n)
+        error ("Octave:nonconformant-args",
+               "operator /: nonconformant arguments (op1 is %dx%d, op2 is %dx%d)",
+               rows (B), columns (B), m, n);
+      endif
+
+      ## X * A = B is solved as A' * X' = B'.
+      C = B';
+
+      switch (dA.Type)
+        case {"lu", "banded"}
+          if (! isempty (dA.q))
+            C = C(dA.q,:);
+          endif
+          Y = matrix_type (dA.L', "upper") \ (matrix_type (dA.U', "lower") \ C);
+          Y(dA.p,:) = Y;
+
+        case "chol"
+          Y = dA \ C;
+
+        case "qr"
+          ## Minimum norm solution of the underdetermined system.
+          C = C(dA.q,:);
+          if (dA.IsSparse)
+            Y = dA.Q * (dA.U \ (dA.L \ C));
+          else
+            Y = dA.Q * (matrix_type (dA.U', "lower") \ C);
+          endif
+      endswitch
+
+      X = Y';
+
+    endfunction
+
+    function disp (dA)
+
+      if (nargin != 1)
+        print_usage ();
+      endif
+
+      printf ("  decomposition with properties:\n\n");
+      printf ("    MatrixSize: [%d %d]\n", dA.MatrixSize);
+      printf ("          Type: %s\n\n", dA.Type);
+
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    function [dA, ok] = factorize (dA, A, reuse)
+
+      ## Compute the factors of A.  If REUSE is true, keep the fill-reducing
+      ## ordering of the previous factorization.
+
+      ok = true;
+
+      switch (dA.Type)
+        case "lu"
+          if (! dA.IsSparse)
+            [L, U, p] = lu (A, "vector");
+          elseif (reuse)
+            ## With fewer than 4 outputs, lu keeps the given column order.
+            warning ("off", "Octave:lu:sparse_input", "local");
+            [L, U, p] = lu (A(:,dA.q), "vector");
+          else
+            [L, U, p, q] = lu (A, "vector");
+            dA.q = q;
+          endif
+          dA.p = p;
+          dA.L = matrix_type (L, "lower");
+          dA.U = matrix_type (U, "upper");
+
+        case "banded"
+          warning ("off", "Octave:lu:sparse_input", "local");
+          [L, U, p] = lu (sparse (A), "vector");
+          dA.p = p;
+          dA.L = matrix_type (L, "lower");
+          dA.U = matrix_type (U, "upper");
+
+        case "chol"
+          if (! dA.IsSparse)
+            [R, fail] = chol (A);
+          elseif (reuse)
+            [R, fail] = chol (A(dA.q,dA.q));
+          else
+            [R, fail, q] = chol (A, "vector");
+            dA.q = q;
+          endif
+          if (fail)
+            ok = false;
+            return;
+          endif
+          dA.U = matrix_type (R, "upper");
+          dA.L = matrix_type (R', "lower");
+
+        case "qr"
+          if (dA.IsSparse)
+            if (! reuse)
+              dA.q = colamd (A);
+            endif
+            dA.Q = A(:,dA.q);
+            R = qr (dA.Q, 0);
+            dA.U = matrix_type (R, "upper");
+            dA.L = matrix_type (R', "lower");
+          else
+            [Q, R, q] = qr (A, 0);
+            dA.Q = Q;
+            dA.q = q;
+            dA.U = matrix_type (R, "upper");
+          endif
+      endswitch
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared n, A, b
+%! n = 30;
+%! A = spdiags ([-ones(n,1), 4*ones(n,1), -ones(n,1)], [-1, 0, 1], n, n);
+%! b = (1:n)';
+
+%!test
+%! dA = decomposition (A);
+%! assert (dA.Type, "chol");
+%! assert (dA.MatrixSize, [n, n]);
+%! assert (dA \ b, A \ b, -1e-12);
+%! assert (dA \ [b, 2*b], A \ [b, 2*b], -1e-12);
+%! assert (b' / dA, b' / A, -1e-12);
+
+%!test
+%! dA = decomposition (full (A));
+%! assert (dA.Type, "chol");
+%! assert (dA \ b, full (A) \ b, -1e-12);
+
+%!test
+%! A2 = A + sparse (1, n, 0.5, n, n);
+%! dA = decomposition (A2);
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, A2 \ b, -1e-12);
+%! assert (b' / dA, b' / A2, -1e-12);
+%! dA = decomposition (full (A2));
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, full (A2) \ b, -1e-12);
+%! assert (b' / dA, b' / full (A2), -1e-12);
+
+%!test
+%! dA = decomposition (A, "lu");
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, A \ b, -1e-12);
+%! dA = decomposition (A, "banded");
+%! assert (dA.Type, "banded");
+%! assert (dA \ b, A \ b, -1e-12);
+%! assert (b' / dA, b' / A, -1e-12);
+%! dA = decomposition (full (A), "banded");
+%! assert (dA \ b, A \ b, -1e-12);
+
+%!test
+%! ## Positive diagonal, but indefinite
+%! A2 = [1, 2; 2, 1];
+%! dA = decomposition (A2);
+%! assert (dA.Type, "lu");
+%! assert (dA \ [1; 2], A2 \ [1; 2], -1e-12);
+
+%!test
+%! A3 = [A; speye(n)];
+%! b3 = (1:2*n)';
+%! c = (1:n);
+%! dA = decomposition (A3);
+%! assert (dA.Type, "qr");
+%! assert (dA \ b3, full (A3) \ b3, -1e-10);
+%! assert (c / dA, c / full (A3), -1e-10);
+%! dA = decomposition (full (A3));
+%! assert (dA.Type, "qr");
+%! assert (dA \ b3, full (A3) \ b3, -1e-10);
+%! assert (c / dA, c / full (A3), -1e-10);
+
+%!test
+%! A2 = A + 1i * spdiags (ones (n,1), 1, n, n);
+%! A2 = A2 + A2';
+%! dA = decomposition (A2);
+%! assert (dA.Type, "chol");
+%! assert (dA \ b, A2 \ b, -1e-12);
+%! assert (b' / dA, b' / A2, -1e-12);
+
+## Test refactoring with the same pattern
+%!test
+%! dA = decomposition (A);
+%! for k = 1:3
+%!   A2 = A + k * speye (n);
+%!   dA = refactor (dA, A2);
+%!   assert (dA \ b, A2 \ b, -1e-12);
+%! endfor
+%! A2 = A + sparse (1, n, 0.5, n, n);
+%! dA = decomposition (A2, "lu");
+%! A2(1,n) = 2;
+%! dA = refactor (dA, A2);
+%! assert (dA \ b, A2 \ b, -1e-12);
+%! A3 = [A; speye(n)];
+%! dA = refactor (decomposition (A3), 2 * A3);
+%! assert (dA \ (1:2*n)', full (2 * A3) \ (1:2*n)', -1e-10);
+
+## Test input validation
+%!error <Invalid call> decomposition ()
+%!error <A must be a 2-D floating point> decomposition (int8 (1))
+%!error <A must be a 2-D floating point> decomposition (ones (2,2,2))
+%!error <TYPE must be a string> decomposition (1, 1)
+%!error <unknown TYPE "foo"> decomposition (1, "foo")
+%!error <A must be square> decomposition (ones (2, 3), "lu")
+%!error <must not have more columns than rows> decomposition (ones (2, 3))
+%!error <must be Hermitian positive definite> decomposition ([1, 2; 2, 1], "chol")
+%!error <must match the size> refactor (decomposition (eye (2)), eye (3))
+%!error <must match the size> refactor (decomposition (eye (2)), speye (2))
+%!error <nonconformant arguments> decomposition (eye (2)) \ ones (3, 1)
+%!error <nonconformant arguments> ones (1, 3) / decomposition (eye (2))
@@ -5,7 +5,8 @@ FCN_FILE_DIRS += %reldir%
   %reldir%/profexplore.m \
   %reldir%/profexport.m \
   %reldir%/profile.m \
-  %reldir%/profshow.m
+  %reldir%/profshow.m \
+  %reldir%/profwrite.m
 
 %canon_reldir%dir = $(fcnfiledir)/profiler
 
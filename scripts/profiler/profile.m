@@ -25,27 +25,55 @@
 
 ## -*- texinfo -*-
 ## @deftypefn  {} {} profile on
+## @deftypefnx {} {} profile on -lines
+## @deftypefnx {} {} profile on -memory
+## @deftypefnx {} {} profile on -sample
+## @deftypefnx {} {} profile on -sample @var{interval}
 ## @deftypefnx {} {} profile off
 ## @deftypefnx {} {} profile resume
+## @deftypefnx {} {} profile resume -lines
+## @deftypefnx {} {} profile resume -memory
 ## @deftypefnx {} {} profile clear
 ## @deftypefnx {} {@var{S} =} profile ("status")
 ## @deftypefnx {} {@var{T} =} profile ("info")
+## @deftypefnx {} {@var{F} =} profile ("folded")
 ## Control the built-in profiler.
 ##
 ## @table @code
 ## @item profile on
 ## Start the profiler.  Any previously collected data is cleared.
 ##
+## @item profile on -lines
+## Start the profiler and also record the time spent in each line of the
+## profiled functions.  This has a higher overhead than profiling only
+## functions.
+##
+## @item profile on -memory
+## Start the profiler and also record the memory allocated for the elements
+## of numeric, logical, character, and sparse arrays by each function.  The
+## options @option{-lines} and @option{-memory} may be combined.
+##
+## @item profile on -sample
+## @itemx profile on -sample @var{interval}
+## Start the sampling profiler instead of the instrumenting one.  Every
+## @var{interval} seconds (default 0.01), the call stack of the interpreter
+## is recorded.  Functions are not timed individually, so the overhead is
+## small and independent of the number of function calls.  The samples are
+## retrieved with @code{profile ("folded")}.
+##
 ## @item profile off
 ## Stop profiling.  The collected data can later be retrieved and examined
 ## with @code{T = profile ("info")}.
 ##
 ## @item profile clear
-## Clear all collected profiler data and stop profiling.
+## Clear all collected profiler data and stop profiling.  This also stops
+## and clears the sampling profiler.
 ##
 ## @item profile resume
 ## Restart profiling without clearing the old data.  All newly collected
-## statistics are added to the existing ones.
+## statistics are added to the existing ones.  Lines and memory are recorded
+## if they were before, or if the option @option{-lines} or @option{-memory}
+## is given.
 ##
 ## @item @var{S} = profile ("status")
 ## Return a structure with information about the current status of the
@@ -61,45 +89,110 @@
 ## index into the @code{FunctionTable} identifying the function it corresponds
 ## to as well as data fields for number of calls and time spent at this level
 ## in the call tree.
+##
+## If lines were recorded, the field @code{ExecutedLines} of each entry of
+## @code{FunctionTable} is a matrix with one row
+## @code{[@var{line}, @var{calls}, @var{time}]} for each line of the function
+## that was executed.  The time of a line includes the time spent in the
+## functions it calls.  Otherwise, @code{ExecutedLines} is empty.
+##
+## If memory was recorded, the fields @code{TotalMemAllocated} and
+## @code{TotalMemFreed} give the number of bytes of array memory allocated
+## and freed by each function, and @code{NumAllocations} the number of
+## allocations.  Like @code{TotalTime}, these exclude the functions it calls.
+## @code{PeakMem} is the largest increase of the live array memory during a
+## call of the function, including the functions it calls.  Otherwise, these
+## fields are zero.
+##
+## @item @var{F} = profile ("folded")
+## Return the call stacks recorded by the sampling profiler as a cell array
+## of strings.  Each line holds the names of the functions on the stack,
+## outermost first and separated by semicolons, followed by a space and the
+## number of samples taken in that stack.  This is the "folded stacks" format
+## read by flame graph tools, so the result can be written to a file with
+## one line per element and rendered directly.
 ## @end table
 ##
 ## @seealso{profshow, profexplore}
 ## @end deftypefn
 
-function retval = profile (arg)
+function retval = profile (arg, varargin)
 
   if (nargin < 1)
     print_usage ();
   endif
 
+  lines = false;
+  memory = false;
+  sample = false;
+  if (nargin > 1)
+    if (strcmp (arg, "on") && strcmp (varargin{1}, "-sample")
+        && nargin <= 3)
+      sample = true;
+      if (nargin < 3)
+        interval = 0.01;
+      elseif (ischar (varargin{2}))
+        interval = str2double (varargin{2});
+      else
+        interval = varargin{2};
+      endif
+      if (! (isscalar (interval) && isreal (interval) && interval > 0))
+        error ("profile: INTERVAL must be a positive scalar");
+      endif
+    elseif (any (strcmp (arg, {"on", "resume"}))
+            && iscellstr (varargin)
+            && all (ismember (varargin, {"-lines", "-memory"})))
+      lines = any (strcmp (varargin, "-lines"));
+      memory = any (strcmp (varargin, "-memory"));
+    else
+      error ("profile: invalid option for '%s'", arg);
+    endif
+  endif
+
   switch (arg)
     case "on"
       if (__profiler_enable__ ())
         __profiler_enable__ (false);
       endif
+      __profiler_sample__ (false);
       __profiler_reset__ ();
-      __profiler_enable__ (true);
+      if (sample)
+        __profiler_sample__ (interval);
+      else
+        __profiler_enable__ (true, lines, memory);
+      endif
 
     case "off"
       __profiler_enable__ (false);
+      __profiler_sample__ (false);
 
     case "clear"
       if (__profiler_enable__ ())
         __profiler_enable__ (false);
       endif
+      __profiler_sample__ (false);
       __profiler_reset__ ();
 
     case "resume"
-      __profiler_enable__ (true);
+      if (lines || memory)
+        [~, old_lines, old_memory] = __profiler_enable__ ();
+        __profiler_enable__ (true, lines || old_lines, memory || old_memory);
+      else
+        __profiler_enable__ (true);
+      endif
 
     case "status"
-      enabled = ifelse (__profiler_enable__ (), 'on', 'off');
+      enabled = ifelse (__profiler_enable__ () || __profiler_sample__ (),
+                        'on', 'off');
       retval = struct ("ProfilerStatus", enabled);
 
     case "info"
       [flat, tree] = __profiler_data__ ();
       retval = struct ("FunctionTable", flat, "Hierarchical", tree);
 
+    case "folded"
+      retval = __profiler_folded__ ();
+
     otherwise
       warning ("profile: Unrecognized option '%s'", arg);
       print_usage ();
@@ -137,7 +230,7 @@ endfunction
 %! assert (size (info), [1, 1]);
 %! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
 %! ftbl = info.FunctionTable;
-%! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
+%! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"; "ExecutedLines"; "TotalMemAllocated"; "TotalMemFreed"; "PeakMem"; "NumAllocations"});
 %! hier = info.Hierarchical;
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
 %! profile ("clear");
@@ -147,11 +240,92 @@ endfunction
 %! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
 %! ftbl = info.FunctionTable;
 %! assert (size (ftbl), [0, 1]);
-%! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
+%! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"; "ExecutedLines"; "TotalMemAllocated"; "TotalMemFreed"; "PeakMem"; "NumAllocations"});
 %! hier = info.Hierarchical;
 %! assert (size (hier), [0, 1]);
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
 
+%!test
+%! profile ("on", "-lines");
+%! A = magic (50);
+%! for i = 1:3
+%!   B = trace (A);
+%! endfor
+%! profile ("off");
+%! info = profile ("info");
+%! ftbl = info.FunctionTable;
+%! idx = find (strcmp ({ftbl.FunctionName}, "trace"));
+%! assert (ftbl(idx).NumCalls, 3);
+%! lines = ftbl(idx).ExecutedLines;
+%! assert (columns (lines), 3);
+%! assert (rows (lines) > 0);
+%! assert (all (lines(:,2) == 3));
+%! assert (issorted (lines(:,1)));
+%! assert (all (lines(:,3) >= 0));
+%! profile ("on");
+%! B = trace (A);
+%! profile ("off");
+%! ftbl = profile ("info").FunctionTable;
+%! idx = find (strcmp ({ftbl.FunctionName}, "trace"));
+%! assert (size (ftbl(idx).ExecutedLines), [0, 3]);
+%! profile ("clear");
+
+%!function x = __alloc_test__ (n)
+%!  x = zeros (n, 1);
+%!  y = zeros (n, 1);
+%!  x = sum (x + y);
+%!endfunction
+
+%!test
+%! profile ("on", "-memory");
+%! x = __alloc_test__ (1e5);
+%! profile ("off");
+%! ftbl = profile ("info").FunctionTable;
+%! idx = find (strcmp ({ftbl.FunctionName}, "__alloc_test__"));
+%! assert (ftbl(idx).NumCalls, 1);
+%! assert (ftbl(idx).PeakMem >= 2 * 8e5);
+%! izeros = find (strcmp ({ftbl.FunctionName}, "zeros"));
+%! assert (ftbl(izeros).NumAllocations >= 2);
+%! assert (ftbl(izeros).TotalMemAllocated >= 2 * 8e5);
+%! profile ("resume", "-lines");
+%! x = __alloc_test__ (10);
+%! profile ("off");
+%! [~, lines, memory] = __profiler_enable__ ();
+%! assert ([lines, memory], [true, true]);
+%! profile ("on");
+%! x = __alloc_test__ (10);
+%! profile ("off");
+%! ftbl = profile ("info").FunctionTable;
+%! idx = find (strcmp ({ftbl.FunctionName}, "zeros"));
+%! assert ([ftbl(idx).TotalMemAllocated, ftbl(idx).PeakMem], [0, 0]);
+%! profile ("clear");
+
+%!test
+%! profile ("on", "-sample", 0.001);
+%! assert (profile ("status").ProfilerStatus, "on");
+%! t0 = tic ();
+%! while (toc (t0) < 0.2)
+%!   B = trace (magic (50));
+%! endwhile
+%! profile ("off");
+%! assert (profile ("status").ProfilerStatus, "off");
+%! F = profile ("folded");
+%! assert (iscellstr (F));
+%! assert (! isempty (F));
+%! assert (all (strncmp (F, "<top level>", 11)));
+%! counts = cellfun (@(s) str2double (s(find (s == " ", 1, "last"):end)), F);
+%! assert (all (counts >= 1));
+%! assert (isempty (profile ("info").FunctionTable));
+%! profile ("clear");
+%! assert (isempty (profile ("folded")));
+
 ## Test input validation
 %!error <Invalid call> profile ()
 %!error profile ("INVALID_OPTION")
+%!error <invalid option for 'off'> profile ("off", "-lines")
+%!error <invalid option for 'on'> profile ("on", "-detail")
+%!error <invalid option for 'resume'> profile ("resume", "-sample")
+%!error <invalid option for 'off'> profile ("off", "-memory")
+%!error <invalid option for 'on'> profile ("on", "-memory", "-detail")
+%!error <INTERVAL must be a positive> profile ("on", "-sample", 0)
+%!error <INTERVAL must be a positive> profile ("on", "-sample", "abc")
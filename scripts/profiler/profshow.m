@@ -40,6 +40,9 @@
 ##
 ## The attribute column displays @samp{R} for recursive functions, and is blank
 ## for all other function types.
+##
+## If the profile was recorded with @code{profile on -lines}, the @var{n}
+## lines with the most time spent in them are listed as well.
 ## @seealso{profexplore, profile}
 ## @end deftypefn
 
@@ -91,6 +94,42 @@ function profshow (data, n = 20)
             row.TotalTime, timePercent, row.NumCalls);
   endfor
 
+  if (! isfield (data.FunctionTable, "ExecutedLines"))
+    return;
+  endif
+
+  ## Collect [function index, line, calls, time] for all recorded lines.
+  lines = cell (m, 1);
+  for i = 1 : m
+    fcnLines = data.FunctionTable(i).ExecutedLines;
+    lines{i} = [i * ones(rows (fcnLines), 1), fcnLines];
+  endfor
+  lines = vertcat (zeros (0, 4), lines{:});
+
+  if (isempty (lines))
+    return;
+  endif
+
+  nLines = min (n, rows (lines));
+  [~, p] = sort (lines(:,4), "descend");
+  p = p(1:nLines);
+
+  nameLen = max (length ("Function"),
+                 columns (char (data.FunctionTable(lines(p,1)).FunctionName)));
+  headerFormat = sprintf ("%%4s %%%ds %%6s %%12s %%10s %%12s\n", nameLen);
+  rowFormat = sprintf ("%%4d %%%ds %%6d %%12.3f %%10.2f %%12d\n", nameLen);
+
+  printf ("\n");
+  printf (headerFormat, ...
+          "#", "Function", "Line", "Time (s)", "Time (%)", "Calls");
+  printf ("%s\n", repmat ("-", 1, nameLen + 2 * 5 + 13 + 2 * 13));
+
+  for i = 1 : nLines
+    row = lines(p(i),:);
+    printf (rowFormat, row(1), data.FunctionTable(row(1)).FunctionName,
+            row(2), row(4), 100 * row(4) / totalTime, row(3));
+  endfor
+
 endfunction
 
 
@@ -108,6 +147,12 @@ endfunction
 %! profile off;
 %! profshow (profile ("info"), 5);
 
+%!demo
+%! profile on -lines;
+%! expm (rand (500) + eye (500));
+%! profile off;
+%! profshow (profile ("info"), 5);
+
 ## Test input validation
 %!error <N must be a positive integer> profshow (struct (), ones (2))
 %!error <N must be a positive integer> profshow (struct (), 1+i)
@@ -0,0 +1,314 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn  {} {} profwrite (@var{file}, @var{format})
+## @deftypefnx {} {} profwrite (@var{file}, @var{format}, @var{data})
+##
+## Export profiler data in a format read by external profiling tools.
+##
+## Write the profiling data in @var{data} to the file @var{file}.  The input
+## @var{data} is the structure returned by @code{profile ("info")}.  If
+## unspecified, @code{profwrite} will use the current profile dataset.
+##
+## The output format @var{format} is one of the following strings:
+##
+## @table @asis
+## @item @qcode{"chrome"}
+## Trace event JSON as read by the trace viewers of web browsers and by
+## Perfetto.  The hierarchical call tree is written as nested events, with
+## the calls of each node of the tree merged into a single event whose
+## duration is the total time spent in it.
+##
+## @item @qcode{"callgrind"}
+## The callgrind profile format as read by KCachegrind and
+## @command{callgrind_annotate}.  Times are given in microseconds.
+##
+## @item @qcode{"folded"}
+## Folded stacks as read by flame graph tools.  Each line holds the names of
+## the functions on a path of the call tree, separated by semicolons, and the
+## self time of the last of them in microseconds.  If @var{data} is the cell
+## array returned by @code{profile ("folded")}, the samples of the sampling
+## profiler are written instead.  This is also the case when @var{data} is
+## unspecified and the sampling profiler has recorded samples, even if it has
+## already been stopped.
+## @end table
+##
+## @seealso{profile, profexport, profshow}
+## @end deftypefn
+
+function profwrite (file, format, data)
+
+  if (nargin < 2)
+    print_usage ();
+  endif
+
+  if (! ischar (file))
+    error ("profwrite: FILE must be a string");
+  endif
+
+  if (! ischar (format))
+    error ("profwrite: FORMAT must be a string");
+  endif
+
+  format = lower (format);
+
+  if (nargin == 2)
+    data = {};
+    if (strcmp (format, "folded"))
+      ## Samples of the sampling profiler, if there are any
+      data = profile ("folded");
+    endif
+    if (isempty (data))
+      data = profile ("info");
+    endif
+  endif
+
+  if (iscellstr (data))
+    if (! strcmp (format, "folded"))
+      error ("profwrite: sampled stacks can only be written as \"folded\"");
+    endif
+    lines = data(:).';
+  elseif (isstruct (data) && isfield (data, "FunctionTable")
+          && isfield (data, "Hierarchical"))
+    switch (format)
+      case "chrome"
+        lines = __chrome_trace__ (data.FunctionTable, data.Hierarchical);
+      case "callgrind"
+        lines = __callgrind__ (data.FunctionTable, data.Hierarchical);
+      case "folded"
+        lines = __folded__ (data.FunctionTable, data.Hierarchical, "", {});
+      otherwise
+        error ("profwrite: unknown FORMAT '%s'", format);
+    endswitch
+  else
+    error ("profwrite: DATA must be the structure from profile (\"info\")");
+  endif
+
+  fid = fopen (file, "w");
+  if (fid < 0)
+    error ("profwrite: failed to open '%s' for writing", file);
+  endif
+  unwind_protect
+    fprintf (fid, "%s\n", lines{:});
+  unwind_protect_cleanup
+    fclose (fid);
+  end_unwind_protect
+
+endfunction
+
+################################################################################
+## Chrome trace event format.
+
+function lines = __chrome_trace__ (funcs, tree)
+
+  events = __chrome_events__ (funcs, tree, 0, {});
+  if (! isempty (events))
+    events(1:end-1) = strcat (events(1:end-1), ",");
+  endif
+
+  lines = [{'{"displayTimeUnit":"ms","traceEvents":['}, events, {"]}"}];
+
+endfunction
+
+## Nodes of the call tree have no start time, so the children of each node
+## are laid out one after the other from the start of their parent.
+
+function events = __chrome_events__ (funcs, nodes, t0, events)
+
+  for i = 1 : numel (nodes)
+    node = nodes(i);
+    events{end+1} = sprintf (['{"name":%s,"cat":"octave","ph":"X",' ...
+                              '"ts":%.3f,"dur":%.3f,"pid":1,"tid":1,' ...
+                              '"args":{"calls":%d,"self_us":%.3f}}'],
+                             jsonencode (funcs(node.Index).FunctionName),
+                             1e6 * t0, 1e6 * node.TotalTime,
+                             node.NumCalls, 1e6 * node.SelfTime);
+    events = __chrome_events__ (funcs, node.Children, t0, events);
+    t0 += node.TotalTime;
+  endfor
+
+endfunction
+
+################################################################################
+## Callgrind format.
+
+function lines = __callgrind__ (funcs, tree)
+
+  nf = numel (funcs);
+  [edges, self] = __call_edges__ (tree, 0);
+
+  selftime = round (1e6 * accumarray (self(:,1), self(:,2), [nf, 1]));
+  calls = sparse (edges(:,1), edges(:,2), edges(:,3), nf, nf);
+  incltime = sparse (edges(:,1), edges(:,2), edges(:,4), nf, nf);
+
+  lines = {"# callgrind format", "version: 1", "creator: Octave", ...
+           "positions: line", "events: Time", ...
+           sprintf ("summary: %d", sum (selftime))};
+
+  ## Function names are compressed: the first reference to a function
+  ## gives its name, later ones only the number.
+  named = false (nf, 1);
+  for f = 1 : nf
+    lines{end+1} = "";
+    [lines{end+1}, named] = __callgrind_name__ ("fn", f, funcs, named);
+    lines{end+1} = sprintf ("0 %d", selftime(f));
+    callees = find (calls(f,:));
+    for c = callees
+      [lines{end+1}, named] = __callgrind_name__ ("cfn", c, funcs, named);
+      lines{end+1} = sprintf ("calls=%d 0", full (calls(f,c)));
+      lines{end+1} = sprintf ("0 %d", round (1e6 * full (incltime(f,c))));
+    endfor
+  endfor
+
+endfunction
+
+function [line, named] = __callgrind_name__ (key, f, funcs, named)
+
+  if (named(f))
+    line = sprintf ("%s=(%d)", key, f);
+  else
+    line = sprintf ("%s=(%d) %s", key, f, funcs(f).FunctionName);
+    named(f) = true;
+  endif
+
+endfunction
+
+## Collect the caller/callee pairs of the call tree as rows
+## [caller, callee, calls, inclusive time] and the self times as rows
+## [function, self time].
+
+function [edges, self] = __call_edges__ (nodes, caller)
+
+  edges = zeros (0, 4);
+  self = zeros (0, 2);
+  for i = 1 : numel (nodes)
+    node = nodes(i);
+    self(end+1,:) = [node.Index, node.SelfTime];
+    if (caller > 0)
+      edges(end+1,:) = [caller, node.Index, node.NumCalls, node.TotalTime];
+    endif
+    [e, s] = __call_edges__ (node.Children, node.Index);
+    edges = [edges; e];
+    self = [self; s];
+  endfor
+
+endfunction
+
+################################################################################
+## Folded stacks.
+
+function lines = __folded__ (funcs, nodes, prefix, lines)
+
+  for i = 1 : numel (nodes)
+    node = nodes(i);
+    stack = [prefix, funcs(node.Index).FunctionName];
+    weight = round (1e6 * node.SelfTime);
+    if (weight > 0)
+      lines{end+1} = sprintf ("%s %d", stack, weight);
+    endif
+    lines = __folded__ (funcs, node.Children, [stack, ";"], lines);
+  endfor
+
+endfunction
+
+
+%!demo
+%! profile on;
+%! A = rand (100);
+%! B = expm (A);
+%! profile off;
+%! file = [tempname(), ".json"];
+%! profwrite (file, "chrome");
+%! printf ("Load %s into a trace viewer\n", file);
+
+%!test
+%! profile on;
+%! A = magic (50);
+%! for i = 1:3
+%!   B = trace (A);
+%! endfor
+%! profile off;
+%! data = profile ("info");
+%! file = tempname ();
+%! unwind_protect
+%!   profwrite (file, "chrome", data);
+%!   trace = jsondecode (fileread (file));
+%!   assert (isfield (trace, "traceEvents"));
+%!   names = {trace.traceEvents.name};
+%!   assert (any (strcmp (names, "trace")));
+%!   assert (all (strcmp ({trace.traceEvents.ph}, "X")));
+%!   idx = find (strcmp (names, "trace"), 1);
+%!   assert (trace.traceEvents(idx).args.calls, 3);
+%!
+%!   profwrite (file, "callgrind", data);
+%!   str = fileread (file);
+%!   assert (strncmp (str, "# callgrind format", 18));
+%!   assert (! isempty (strfind (str, "events: Time")));
+%!   itrace = find (strcmp ({data.FunctionTable.FunctionName}, "trace"));
+%!   assert (! isempty (regexp (str, sprintf ("fn=\\(%d\\) trace\\n", itrace),
+%!                              "once")));
+%!   assert (! isempty (strfind (str, "calls=3 0")));
+%!
+%!   profwrite (file, "folded", data);
+%!   lines = strsplit (strtrim (fileread (file)), "\n");
+%!   assert (all (cellfun (@(s) ! isempty (regexp (s, ' \d+$', "once")),
+%!                         lines)));
+%!
+%!   profwrite (file, "folded", {"<top level>;f 3"; "<top level>;g 1"});
+%!   assert (fileread (file), "<top level>;f 3\n<top level>;g 1\n");
+%! unwind_protect_cleanup
+%!   unlink (file);
+%!   profile clear;
+%! end_unwind_protect
+
+## The samples are written after the sampling profiler is stopped
+%!test
+%! profile on -sample 0.001;
+%! t0 = tic ();
+%! while (toc (t0) < 0.2)
+%!   B = trace (magic (50));
+%! endwhile
+%! profile off;
+%! file = tempname ();
+%! unwind_protect
+%!   profwrite (file, "folded");
+%!   lines = strsplit (strtrim (fileread (file)), "\n");
+%!   assert (lines, profile ("folded")(:).');
+%!   assert (all (strncmp (lines, "<top level>", 11)));
+%! unwind_protect_cleanup
+%!   unlink (file);
+%!   profile clear;
+%! end_unwind_protect
+
+## Test input validation
+%!error <Invalid call> profwrite ()
+%!error <Invalid call> profwrite ("file")
+%!error <FILE must be a string> profwrite (1, "chrome")
+%!error <FORMAT must be a string> profwrite ("file", 1)
+%!error <unknown FORMAT 'xml'>
+%! profwrite ("file", "xml", struct ("FunctionTable", [], "Hierarchical", []));
+%!error <DATA must be the structure> profwrite ("file", "chrome", 1)
+%!error <can only be written as "folded"> profwrite ("file", "chrome", {"a 1"})
@@ -430,6 +430,14 @@ endfunction
 %! opts.michol = "on";
 %! L = ichol (A5, opts);
 %! assert (norm (A5 - L*L', "fro") / norm (A5, "fro"), 0.3231, 1e-4);
+%!test
+%! ## IC(0) reproduces a large matrix on its sparsity pattern
+%! m = 200;
+%! e = ones (m, 1);
+%! T = spdiags ([-e, 2*e, -e], -1:1, m, m);
+%! A = kron (speye (m), T) + kron (T, speye (m));
+%! L = ichol (A);
+%! assert (norm ((L*L' - A) .* spones (A), 1), 0, 1e-12 * norm (A, 1));
 
 ## Test input validation
 %!error <A must be a sparse square matrix> ichol ([])
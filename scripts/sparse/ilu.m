@@ -272,6 +272,12 @@ endfunction
 %!test
 %! opts.type = "nofill";
 %! assert (nnz (ilu (A, opts)), 7840);
+%!test
+%! ## ILU(0) reproduces a large matrix on its sparsity pattern
+%! B = gallery ("neumann", 25600) + speye (25600);
+%! opts.type = "nofill";
+%! [L, U] = ilu (B, opts);
+%! assert (norm ((L*U - B) .* spones (B), 1), 0, 1e-12 * norm (B, 1));
 
 ## This test has been verified in both Matlab and Octave.
 %!test
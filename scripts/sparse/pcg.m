@@ -301,79 +301,94 @@ function [x_min, flag, relres, iter_min, resvec, eigest] =...
   ## x_pr (x previous) needs to check the stagnation
   ## x_min needs to save the iterated with minimum residual
 
-  r = b - feval (Afcn, x, varargin{:});
-  iter = 2;
-  iter_min = 0;
-  flag = 1;
-  resvec = zeros (maxit + 1, 2);
-  resvec(1, 1) = norm (r);
-  p = zeros (size (b));
-  alpha = old_tau = 1;
-
-  if (n_arg_out > 5)
-    T = zeros (maxit, maxit);
+  ## Real double matrices and preconditioners are handled by a compiled
+  ## version of the iteration below.  Function handles, extra arguments, and
+  ## the eigenvalue estimate need the m-file code.
+  use_builtin = (n_arg_out < 6 && isempty (varargin)
+                 && is_builtin_operand (A, A) && is_builtin_operand (b)
+                 && is_builtin_operand (x0) && iscolumn (b)
+                 && size_equal (b, x0)
+                 && (isempty (M1) || is_builtin_operand (M1, A))
+                 && (isempty (M2) || is_builtin_operand (M2, A)));
+
+  if (use_builtin)
+    [x_min, flag, resvec, iter, iter_min] = __pcg__ (A, b, tol, maxit, ...
+                                                     M1, M2, x0);
   else
-    T = [];
-  endif
+    r = b - feval (Afcn, x, varargin{:});
+    iter = 2;
+    iter_min = 0;
+    flag = 1;
+    resvec = zeros (maxit + 1, 2);
+    resvec(1, 1) = norm (r);
+    p = zeros (size (b));
+    alpha = old_tau = 1;
+
+    if (n_arg_out > 5)
+      T = zeros (maxit, maxit);
+    else
+      T = [];
+    endif
 
-  while (resvec(iter-1,1) > tol * b_norm && iter < maxit)
-    if (iter == 2) # Check whether M1 or M2 are singular
-      try
-        warning ("error","Octave:singular-matrix","local");
+    while (resvec(iter-1,1) > tol * b_norm && iter < maxit)
+      if (iter == 2) # Check whether M1 or M2 are singular
+        try
+          warning ("error","Octave:singular-matrix","local");
+          z = feval (M1fcn, r, varargin{:});
+          z = feval (M2fcn, z, varargin{:});
+        catch
+          flag = 2;
+          break;
+        end_try_catch
+      else
         z = feval (M1fcn, r, varargin{:});
         z = feval (M2fcn, z, varargin{:});
-      catch
-        flag = 2;
-        break;
-      end_try_catch
-    else
-      z = feval (M1fcn, r, varargin{:});
-      z = feval (M2fcn, z, varargin{:});
-    endif
+      endif
 
-    tau = z' * r;
-    resvec(iter - 1, 2) = sqrt (tau);
-    beta = tau / old_tau;
-    old_tau = tau;
-    p = z + beta * p;
-    w = feval (Afcn, p, varargin{:});
-
-    ## Needed only for eigest.
-
-    old_alpha = alpha;
-    den = p' * w;
-    alpha = tau / den;
-
-    ## Check if alpha is negative and/or if it has a consistent
-    ## imaginary part: if yes then A probably is not positive definite
-    if ((abs (imag (tau)) >= abs (real (tau)) * tol) || ...
-        real (tau) <= 0 || ...
-        (abs (imag (den)) >= abs (real (den)) * tol) || ...
-        (real (den) <= 0))
-      flag = 4;
-      break;
-    endif
+      tau = z' * r;
+      resvec(iter - 1, 2) = sqrt (tau);
+      beta = tau / old_tau;
+      old_tau = tau;
+      p = z + beta * p;
+      w = feval (Afcn, p, varargin{:});
+
+      ## Needed only for eigest.
+
+      old_alpha = alpha;
+      den = p' * w;
+      alpha = tau / den;
+
+      ## Check if alpha is negative and/or if it has a consistent
+      ## imaginary part: if yes then A probably is not positive definite
+      if ((abs (imag (tau)) >= abs (real (tau)) * tol) || ...
+          real (tau) <= 0 || ...
+          (abs (imag (den)) >= abs (real (den)) * tol) || ...
+          (real (den) <= 0))
+        flag = 4;
+        break;
+      endif
 
-    x += alpha * p;
-    r -= alpha * w;
-    resvec(iter, 1) = norm (r);
-    ## Check if the iterated has minimum residual
-    if (resvec (iter,1) <= resvec (iter_min + 1,1))
-      x_min = x;
-      iter_min = iter - 1;
-    endif
-    if (n_arg_out > 5 && iter > 2)
-      T(iter-1:iter, iter-1:iter) = T(iter-1:iter, iter-1:iter) + ...
-                                    [1, sqrt(beta); sqrt(beta), beta] ./ ...
-                                    old_alpha;
-    endif
-    iter += 1;
-    if (norm (x - x_pr) <= eps * norm (x)) # Check the stagnation
-      flag = 3;
-      break;
-    endif
-    x_pr = x;
-  endwhile
+      x += alpha * p;
+      r -= alpha * w;
+      resvec(iter, 1) = norm (r);
+      ## Check if the iterated has minimum residual
+      if (resvec (iter,1) <= resvec (iter_min + 1,1))
+        x_min = x;
+        iter_min = iter - 1;
+      endif
+      if (n_arg_out > 5 && iter > 2)
+        T(iter-1:iter, iter-1:iter) = T(iter-1:iter, iter-1:iter) + ...
+                                      [1, sqrt(beta); sqrt(beta), beta] ./ ...
+                                      old_alpha;
+      endif
+      iter += 1;
+      if (norm (x - x_pr) <= eps * norm (x)) # Check the stagnation
+        flag = 3;
+        break;
+      endif
+      x_pr = x;
+    endwhile
+  endif
 
   if (n_arg_out > 5)
   ## Apply the preconditioner once more and finish with the precond
@@ -457,6 +472,17 @@ function [x_min, flag, relres, iter_min, resvec, eigest] =...
 
 endfunction
 
+## Other special matrices, e.g., permutation matrices, would be converted to
+## full matrices by __pcg__.
+
+function tf = is_builtin_operand (X, A)
+  tf = any (strcmp (typeinfo (X),
+                    {"scalar", "matrix", "diagonal matrix", "sparse matrix"}));
+  if (nargin > 1)
+    tf = tf && size_equal (X, A);
+  endif
+endfunction
+
 
 %!demo # simplest use
 %! n = 10;
@@ -534,6 +560,27 @@ endfunction
 %! [x, flag] = pcg (Afcn, b,[],[], M1_fcn, M2_fcn);
 %! assert (flag, 0);
 
+%!test
+%! ## Matrix inputs give the same iterates as function handle inputs
+%! N = 50;
+%! A = spdiags ([-ones(N,1), 4*ones(N,1), -ones(N,1)], [-1, 0, 1], N, N);
+%! b = A * (1:N)';
+%! L = ichol (A);
+%! Afcn = @(z) A*z;
+%! L_fcn = @(z) L \ z;
+%! Lt_fcn = @(z) L' \ z;
+%! [x1, flag1, relres1, iter1, resvec1] = pcg (A, b, 1e-10, N, L, L');
+%! [x2, flag2, relres2, iter2, resvec2] = pcg (Afcn, b, 1e-10, N, L_fcn, Lt_fcn);
+%! assert (flag1, flag2);
+%! assert (iter1, iter2);
+%! assert (x1, x2, 1e-10);
+%! assert (resvec1, resvec2, 1e-10 * norm (b));
+%! [x1, flag1, relres1, iter1] = pcg (full (A), b, 1e-10, N);
+%! [x2, flag2, relres2, iter2] = pcg (Afcn, b, 1e-10, N);
+%! assert (flag1, flag2);
+%! assert (iter1, iter2);
+%! assert (x1, x2, 1e-10);
+
 %!test
 %! ## solve a small diagonal system
 %! N = 10;
@@ -632,6 +679,31 @@ endfunction
 %! [x, flag] = pcg (A, ones (3, 1), [], [], M);
 %! assert (flag, 2);
 
+%!test
+%! ## singular preconditioners that are not triangular
+%! A = toeplitz ([2, 1, 0]);
+%! [x, flag] = pcg (A, ones (3, 1), [], [], [1 1 0; 1 1 0; 0 0 1]);
+%! assert (flag, 2);
+%! [x, flag] = pcg (A, ones (3, 1), [], [], [1 1 0; 1 1+eps 0; 0 0 1]);
+%! assert (flag, 2);
+
+%!testif HAVE_UMFPACK
+%! ## singular sparse preconditioner, without a warning
+%! A = sparse (toeplitz ([2, 1, 0]));
+%! M = sparse ([1 1 0; 1 1 0; 0 0 1]);
+%! lastwarn ("");
+%! [x, flag] = pcg (A, ones (3, 1), [], [], M);
+%! assert (flag, 2);
+%! assert (lastwarn (), "");
+
+%!test
+%! ## diagonal preconditioner
+%! A = toeplitz ([4, 1, 0, 0, 0]);
+%! b = ones (5, 1);
+%! [x, flag] = pcg (A, b, 1e-10, 10, diag (diag (A)));
+%! assert (flag, 0);
+%! assert (x, A \ b, -1e-8);
+
 %!test
 %! A = rand (4);
 %! A = A' * A;
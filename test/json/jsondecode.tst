@@ -623,3 +623,15 @@
 %!                          "makeValidName", true, ...
 %!                          "Prefix", "n");
 %! assert (isequal (obs, exp));
+
+%%% Test 11: Nested numeric and Boolean arrays of regular and irregular shape
+
+%!testif HAVE_RAPIDJSON
+%! assert (isequaln (jsondecode ('[[[1, 2], [3, 4]], [[5, 6], [7, null]]]'), ...
+%!                   cat (3, [1, 3; 5, 7], [2, 4; 6, NaN])));
+%! assert (isequal (jsondecode ('[[true, false], [false, false]]'), ...
+%!                  [true, false; false, false]));
+%! assert (isequaln (jsondecode ('[[1, null], [null, 2]]'), [1, NaN; NaN, 2]));
+%! assert (isequal (jsondecode ('[[[1], [2]], [1, 2]]'), [1, 2; 1, 2]));
+%! assert (isequal (jsondecode ('[[1, 2], [true, false]]'), ...
+%!                  {[1; 2]; [true; false]}));
@@ -84,6 +84,9 @@
 #        left and right matrix division operators of square matrices.
 #    helper gen_matrixop_tests
 #        rectangular matrix binary operators: *
+#    gen_threaded_matrixop_tests
+#        sparse * full and sparse * sparse products large enough to be
+#        split among threads
 #    helper gen_matrixdiag_tests
 #        Tests extract of diag and creation of diagonal matrices using
 #        diag and spdiags functions
@@ -201,6 +204,18 @@ cat <<EOF
 %!error <wrong type argument 'uint8 matrix'>
 %! s = sparse ([1,1],[1,1], uint8 ([1,2]), 2, 2);
 
+%% conversion from single precision
+%!test
+%! warning ("off", "Octave:sparse:double-conversion", "local");
+%! a = single ([0, 1.5, 0; NaN, 0, -Inf]);
+%! s = sparse (a);
+%! assert (class (s), "double");
+%! assert (s, sparse (double (a)));
+%! assert (nnz (s), 3);
+%! s = sparse (a + 2i * a);
+%! assert (s, sparse (double (a + 2i * a)));
+%! assert (iscomplex (s));
+
 %!test # segfault test from edd@debian.org
 %! n = 510;
 %! sparse (kron ((1:n)', ones (n,1)), kron (ones (n,1), (1:n)'), ones (n));
@@ -404,6 +419,49 @@ gen_matrixop_tests() {
 EOF
 }
 
+# test products large enough to use threads
+gen_threaded_matrixop_tests() {
+    cat <<EOF
+%% Sparse * full products large enough to be split among threads
+%!test
+%! A = sprandn (2000, 1500, 0.05);
+%! Af = full (A);
+%! x = randn (1500, 3);
+%! y = randn (2000, 3);
+%! assert (A * x, Af * x, 1e-10);
+%! assert (A * x(:,1), Af * x(:,1), 1e-10);
+%! assert (A' * y, Af' * y, 1e-10);
+%! Ac = A + 1i * sprandn (A);
+%! Acf = full (Ac);
+%! assert (Ac * x, Acf * x, 1e-10);
+%! assert (Ac.' * y, Acf.' * y, 1e-10);
+%! assert (Ac' * y, Acf' * y, 1e-10);
+
+%% The sums of A*x are formed in the order of the columns of A
+%!test
+%! A = sprandn (2000, 1500, 0.05);
+%! x = randn (1500, 1);
+%! y = zeros (2000, 1);
+%! for j = 1:columns (A)
+%!   y += A(:,j) * x(j);
+%! endfor
+%! assert (A * x, y);
+
+%% Sparse * sparse products with both sparse and dense result columns
+%!test
+%! A = sprandn (1000, 800, 0.01);
+%! B = sprandn (800, 600, 0.02);
+%! B(:,1:5) = sprandn (800, 5, 0.5);
+%! C = A * B;
+%! assert (issparse (C));
+%! assert (full (C), full (A) * full (B), 1e-10);
+%! Bc = B + 1i * sprandn (B);
+%! assert (full (A * Bc), full (A) * full (Bc), 1e-10);
+%! assert (full (Bc' * A'), full (Bc)' * full (A)', 1e-10);
+
+EOF
+}
+
 # test diagonal operations
 gen_matrixdiag_tests() {
     cat <<EOF
@@ -1363,3 +1421,6 @@ gen_solver_tests
 echo '%!test alpha=1i; beta=1i;'
 gen_solver_tests
 gen_section
+
+gen_threaded_matrixop_tests
+gen_section